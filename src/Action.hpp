@@ -1,19 +1,56 @@
 #pragma once
 
-#include <sstream>
-#include <string>
+#include <cstdint>
+#include <type_traits>
 #include "Vec2.hpp"
 
+// Every action a scene can receive. Scenes dispatch on these with a switch,
+// which the compiler turns into a jump table.
+enum class ActionName : uint8_t
+{
+	NONE,
+	LEFT,
+	RIGHT,
+	UP,
+	DOWN,
+	ESCAPE,
+	QUIT,
+	PLAY,
+	NEW_WEAPON,
+	LEVEL_WEAPON,
+	DISPLAY_HITBOX,
+	TOGGLE_AUTO_AIM,
+	TOGGLE_AUTO_ATTACK,
+	RING_ATTACK,
+	EXPLODE_ATTACK,
+	WHIRL_ATTACK,
+	BULLET_ATTACK,
+	LEFT_CLICK,
+	MIDDLE_CLICK,
+	RIGHT_CLICK,
+	MOUSE_MOVE,
+	COUNT
+};
+
+enum class ActionType : uint8_t
+{
+	NONE,
+	START,
+	END
+};
+
 class Action
 {
 public:
-	std::string m_name = "NONE";
-	std::string m_type = "NONE";
+	ActionName m_name = ActionName::NONE;
+	ActionType m_type = ActionType::NONE;
 	Vec2f m_mousePos = { 0, 0 };
 
 	Action() = default;
-	Action(const std::string& name, const std::string& type)
+	Action(ActionName name, ActionType type)
 		: m_name(name), m_type(type) { }
-	Action(const std::string& name, const std::string& type, const Vec2f& mousePos)
+	Action(ActionName name, ActionType type, const Vec2f& mousePos)
 		: m_name(name), m_type(type), m_mousePos(mousePos) {}
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable<Action>::value, "Action must stay trivially copyable");
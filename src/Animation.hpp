@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AssetId.hpp"
 #include "Vec2.hpp"
 
 #include <vector>
@@ -9,13 +10,14 @@
 class Animation
 {
 public:
-	sf::Texture m_texture;
-	sf::Sprite m_sprite = sf::Sprite(m_texture);
+	// the sprite draws from the texture owned by Assets, so copies stay cheap
+	sf::Sprite m_sprite = sf::Sprite(noTexture());
 	size_t m_frameCount = 1; // total number of frames of animation
 	size_t m_currentFrame = 0; // the current frame of animation being played
 	size_t m_speed = 0; // the speed or duration to play this animation
 	Vec2f m_size = { 1, 1 }; // size of the animation frame
 	std::string m_name = "none";
+	AnimationId m_id; // set by Assets, compare this instead of m_name
 	size_t m_rows = 1;
 	size_t m_cols = 1;
 
@@ -24,7 +26,7 @@ public:
 		: Animation(name, t, 1, 1, 1, 0) { }
 	Animation(const std::string& name, const sf::Texture& t,
 		size_t rows, size_t cols, size_t frameCount, size_t speed)
-		: m_name(name), m_texture(t), m_sprite(t), m_rows(rows), m_cols(cols)
+		: m_name(name), m_sprite(t), m_rows(rows), m_cols(cols)
 		, m_frameCount(frameCount), m_currentFrame(0), m_speed(speed)
 	{
 
@@ -46,6 +48,12 @@ public:
 		}
 	}
 
+	static const sf::Texture& noTexture()
+	{
+		static const sf::Texture texture;
+		return texture;
+	}
+
 	bool hasEnded() const
 	{
 		return (m_currentFrame >= m_frameCount * m_speed);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// Index into one of the Assets tables. Scenes resolve names to ids once in
+// init() so per-frame lookups are a plain array access.
+template <typename Tag>
+struct AssetId
+{
+	static constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
+	uint32_t index = Invalid;
+
+	bool valid() const
+	{
+		return index != Invalid;
+	}
+
+	bool operator==(const AssetId& rhs) const
+	{
+		return index == rhs.index;
+	}
+
+	bool operator!=(const AssetId& rhs) const
+	{
+		return index != rhs.index;
+	}
+};
+
+struct AnimationTag;
+struct FontTag;
+struct SoundTag;
+
+using AnimationId = AssetId<AnimationTag>;
+using FontId = AssetId<FontTag>;
+using SoundId = AssetId<SoundTag>;
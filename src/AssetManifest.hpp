@@ -0,0 +1,57 @@
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// One line of assets/assets.txt. For animations, path holds the texture name.
+struct AssetManifestEntry
+{
+	std::string type;
+	std::string name;
+	std::string path;
+	size_t rows = 0;
+	size_t cols = 0;
+	size_t frames = 0;
+	size_t speed = 0;
+	size_t maxInstances = 0;
+	int priority = 0;
+};
+
+inline std::vector<AssetManifestEntry> parseAssetManifest(const std::string& path)
+{
+	std::vector<AssetManifestEntry> entries;
+	auto file = std::ifstream(path);
+	if (!file)
+	{
+		std::cerr << "Could not open asset manifest: " << path << std::endl;
+		return entries;
+	}
+
+	std::string str;
+	while (file >> str)
+	{
+		AssetManifestEntry entry;
+		entry.type = str;
+		if (str == "Texture" || str == "Font" || str == "Sound" || str == "Music")
+		{
+			file >> entry.name >> entry.path;
+		}
+		else if (str == "Animation")
+		{
+			file >> entry.name >> entry.path >> entry.rows >> entry.cols >> entry.frames >> entry.speed;
+		}
+		else if (str == "Voice")
+		{
+			file >> entry.name >> entry.maxInstances >> entry.priority;
+		}
+		else
+		{
+			std::cerr << "Unknown Asset Type: " << str << std::endl;
+			continue;
+		}
+		entries.push_back(entry);
+	}
+	return entries;
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "AssetManifest.hpp"
+#include "MappedFile.h"
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Everything in assets.txt baked into one file that is memory-mapped at
+// startup. Textures are stored as decoded RGBA and sounds as raw samples, so
+// loading is an upload or a copy with no decoding. Fonts and music keep their
+// original file bytes and are streamed straight from the mapping.
+//
+// File layout (little endian, blobs 16-byte aligned):
+//   Header, entry blobs..., Entry[entryCount] at indexOffset
+class AssetPack
+{
+public:
+	enum class EntryType : uint32_t
+	{
+		Texture,	// params: width, height; blob: RGBA8 pixels
+		Animation,	// params: rows, cols, frames, speed; blob: texture name
+		Font,		// blob: font file
+		Sound,		// params: channels, sample rate; blob: 8 channel ids, int16 samples
+		Music,		// blob: music file
+		Voice		// params: max instances, priority
+	};
+
+	struct Header
+	{
+		char     magic[4];
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+		uint64_t indexOffset;
+	};
+
+	struct Entry
+	{
+		char      name[48];
+		EntryType type;
+		uint32_t  params[4];
+		uint64_t  offset;
+		uint64_t  size;
+	};
+
+	static constexpr size_t SoundChannelBytes = 8;
+
+private:
+	static constexpr char     Magic[4] = { 'S', 'L', 'P', 'K' };
+	static constexpr uint32_t Version = 1;
+
+	MappedFile   m_file;
+	const Entry* m_entries = nullptr;
+	size_t       m_entryCount = 0;
+
+	static bool readFile(const std::string& path, std::vector<uint8_t>& bytes)
+	{
+		auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+		bytes.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), bytes.size()));
+	}
+
+	static uint64_t align(std::ofstream& out)
+	{
+		uint64_t pos = static_cast<uint64_t>(out.tellp());
+		uint64_t aligned = (pos + 15) & ~uint64_t(15);
+		for (; pos < aligned; pos++)
+			out.put(0);
+		return aligned;
+	}
+
+	static void writeBlob(std::ofstream& out, Entry& entry, const void* data, size_t size)
+	{
+		entry.offset = align(out);
+		entry.size = size;
+		out.write(static_cast<const char*>(data), size);
+	}
+
+	static bool entryType(const std::string& name, EntryType& type)
+	{
+		static const std::pair<const char*, EntryType> types[] = {
+			{ "Texture", EntryType::Texture }, { "Animation", EntryType::Animation },
+			{ "Font", EntryType::Font }, { "Sound", EntryType::Sound },
+			{ "Music", EntryType::Music }, { "Voice", EntryType::Voice } };
+		for (auto& [typeName, value] : types)
+		{
+			if (name == typeName)
+			{
+				type = value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// header, blobs, then the index; false on the first asset that fails
+	static bool writePack(const std::vector<AssetManifestEntry>& manifest, std::ofstream& out)
+	{
+		Header header = {};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = Version;
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+		std::vector<Entry> entries;
+		std::vector<uint8_t> bytes;
+		for (auto& asset : manifest)
+		{
+			Entry entry = {};
+			if (asset.name.size() >= sizeof(entry.name))
+			{
+				std::cerr << "Asset name too long for pack: " << asset.name << std::endl;
+				return false;
+			}
+			std::memcpy(entry.name, asset.name.c_str(), asset.name.size());
+
+			if (asset.type == "Texture")
+			{
+				sf::Image image;
+				if (!image.loadFromFile(asset.path))
+				{
+					std::cerr << "Could not load texture from file: " << asset.path << std::endl;
+					return false;
+				}
+				entry.type = EntryType::Texture;
+				entry.params[0] = image.getSize().x;
+				entry.params[1] = image.getSize().y;
+				writeBlob(out, entry, image.getPixelsPtr(), size_t(image.getSize().x) * image.getSize().y * 4);
+			}
+			else if (asset.type == "Animation")
+			{
+				entry.type = EntryType::Animation;
+				entry.params[0] = static_cast<uint32_t>(asset.rows);
+				entry.params[1] = static_cast<uint32_t>(asset.cols);
+				entry.params[2] = static_cast<uint32_t>(asset.frames);
+				entry.params[3] = static_cast<uint32_t>(asset.speed);
+				writeBlob(out, entry, asset.path.data(), asset.path.size());
+			}
+			else if (asset.type == "Font" || asset.type == "Music")
+			{
+				if (!readFile(asset.path, bytes))
+				{
+					std::cerr << "Could not read asset file: " << asset.path << std::endl;
+					return false;
+				}
+				entry.type = asset.type == "Font" ? EntryType::Font : EntryType::Music;
+				writeBlob(out, entry, bytes.data(), bytes.size());
+			}
+			else if (asset.type == "Sound")
+			{
+				sf::SoundBuffer buffer;
+				if (!buffer.loadFromFile(asset.path) || buffer.getChannelCount() > SoundChannelBytes)
+				{
+					std::cerr << "Could not load sound file: " << asset.path << std::endl;
+					return false;
+				}
+				entry.type = EntryType::Sound;
+				entry.params[0] = buffer.getChannelCount();
+				entry.params[1] = buffer.getSampleRate();
+
+				auto channelMap = buffer.getChannelMap();
+				size_t sampleBytes = buffer.getSampleCount() * sizeof(int16_t);
+				bytes.assign(SoundChannelBytes + sampleBytes, 0);
+				for (size_t c = 0; c < channelMap.size(); c++)
+					bytes[c] = static_cast<uint8_t>(channelMap[c]);
+				std::memcpy(bytes.data() + SoundChannelBytes, buffer.getSamples(), sampleBytes);
+				writeBlob(out, entry, bytes.data(), bytes.size());
+			}
+			else if (asset.type == "Voice")
+			{
+				entry.type = EntryType::Voice;
+				entry.params[0] = static_cast<uint32_t>(asset.maxInstances);
+				entry.params[1] = static_cast<uint32_t>(asset.priority);
+			}
+			entries.push_back(entry);
+		}
+
+		header.indexOffset = align(out);
+		header.entryCount = static_cast<uint32_t>(entries.size());
+		out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		return static_cast<bool>(out);
+	}
+
+public:
+	AssetPack() = default;
+
+	// Rejects a pack that is corrupt, empty, or missing anything the manifest
+	// lists, so the caller falls back to the loose files.
+	bool open(const std::string& path, const std::vector<AssetManifestEntry>& manifest)
+	{
+		close();
+		if (!m_file.open(path))
+			return false;
+
+		Header header;
+		if (m_file.size() < sizeof(Header))
+		{
+			std::cerr << "Asset pack is truncated: " << path << std::endl;
+			close();
+			return false;
+		}
+		std::memcpy(&header, m_file.data(), sizeof(Header));
+
+		if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version ||
+			header.indexOffset % 8 != 0 ||
+			header.indexOffset + uint64_t(header.entryCount) * sizeof(Entry) > m_file.size())
+		{
+			std::cerr << "Asset pack is corrupt or from another version: " << path << std::endl;
+			close();
+			return false;
+		}
+
+		m_entries = reinterpret_cast<const Entry*>(m_file.data() + header.indexOffset);
+		m_entryCount = header.entryCount;
+		for (size_t i = 0; i < m_entryCount; i++)
+		{
+			auto& e = m_entries[i];
+			if (e.name[sizeof(e.name) - 1] != 0 || e.offset + e.size > m_file.size())
+			{
+				std::cerr << "Asset pack entry " << i << " is out of range: " << path << std::endl;
+				close();
+				return false;
+			}
+		}
+
+		if (m_entryCount == 0)
+		{
+			std::cerr << "Asset pack is empty: " << path << std::endl;
+			close();
+			return false;
+		}
+
+		std::unordered_set<std::string> packed;
+		for (size_t i = 0; i < m_entryCount; i++)
+		{
+			packed.insert(std::to_string(static_cast<uint32_t>(m_entries[i].type)) + " " + m_entries[i].name);
+		}
+		for (auto& asset : manifest)
+		{
+			EntryType type;
+			if (!entryType(asset.type, type) || !packed.count(std::to_string(static_cast<uint32_t>(type)) + " " + asset.name))
+			{
+				std::cerr << "Asset pack has no " << asset.type << " " << asset.name << ": " << path << std::endl;
+				close();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void close()
+	{
+		m_file.close();
+		m_entries = nullptr;
+		m_entryCount = 0;
+	}
+
+	bool isOpen() const
+	{
+		return m_file.isOpen();
+	}
+
+	size_t entryCount() const
+	{
+		return m_entryCount;
+	}
+
+	const Entry& entry(size_t i) const
+	{
+		return m_entries[i];
+	}
+
+	// points into the mapping; valid until the pack is closed
+	const uint8_t* data(const Entry& e) const
+	{
+		return m_file.data() + e.offset;
+	}
+
+	// Offline step: decode everything the manifest lists and write the pack.
+	// It is written next to the old one and only renamed over it once
+	// complete, so a failed build leaves the previous pack in place.
+	static bool build(const std::string& manifestPath, const std::string& packPath)
+	{
+		auto manifest = parseAssetManifest(manifestPath);
+		std::string tmpPath = packPath + ".tmp";
+		auto out = std::ofstream(tmpPath, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			std::cerr << "Could not write asset pack: " << tmpPath << std::endl;
+			return false;
+		}
+
+		bool written = writePack(manifest, out);
+		out.close();
+		std::error_code ec;
+		if (!written || !out)
+		{
+			std::cerr << "Could not write asset pack: " << packPath << std::endl;
+			std::filesystem::remove(tmpPath, ec);
+			return false;
+		}
+
+		std::filesystem::rename(tmpPath, packPath, ec);
+		if (ec)
+		{
+			std::cerr << "Could not replace asset pack: " << packPath << " (" << ec.message() << ")" << std::endl;
+			std::filesystem::remove(tmpPath, ec);
+			return false;
+		}
+
+		std::cout << "Packed " << manifest.size() << " assets into " << packPath << std::endl;
+		return true;
+	}
+};
@@ -1,20 +1,277 @@
 #pragma once
 
 #include "Animation.hpp"
+#include "AssetId.hpp"
+#include "AssetManifest.hpp"
+#include "AssetPack.hpp"
+#include "FileWatcher.h"
+#include "SoundManager.hpp"
+#include "ThreadPool.hpp"
+#include <deque>
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <cassert>
+#include <unordered_map>
+#include <unordered_set>
 #include <SFML/Audio.hpp>
 
 class Assets
 {
+	struct DecodedImage
+	{
+		sf::Image image;
+		bool ok = false;
+	};
+
+	struct DecodedSound
+	{
+		std::vector<int16_t> samples;
+		std::vector<sf::SoundChannel> channelMap;
+		unsigned int channels = 0;
+		unsigned int sampleRate = 0;
+		bool ok = false;
+	};
+
+	// one manifest entry on its way in; textures decode on the pool
+	struct PendingAsset
+	{
+		AssetManifestEntry asset;
+		std::future<DecodedImage> image;
+		bool reload = false;
+	};
+
+	// Buffers are decoded on first use (or on prefetch) and can be evicted
+	// again; the settings and source stay so the sound can come back.
+	struct SoundAsset
+	{
+		sf::SoundBuffer buffer;
+		SoundSettings settings;
+		std::string source;
+		const AssetPack::Entry* packEntry = nullptr;
+		std::future<DecodedSound> decoding;
+		bool loaded = false;
+		size_t lastUse = 0;
+		size_t bytes = 0;
+	};
+
+	// music is streamed, so only the source is kept until a scene asks for it
+	struct MusicSource
+	{
+		std::string path;
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+	};
+
+	AssetPack m_pack;
+	std::deque<PendingAsset> m_pending;
+	size_t m_loadTotal = 0;
+	size_t m_loadDone = 0;
+	size_t m_priorityCount = 0;
+	size_t m_soundBudget = 16 * 1024 * 1024;
+	size_t m_soundBytes = 0;
+	size_t m_soundClock = 0;
+	std::vector<uint32_t> m_soundsDecoding;
+
+	FileWatcher m_watcher;
+	ThreadPool* m_reloadPool = nullptr;
+	std::string m_manifestPath;
+	std::vector<AssetManifestEntry> m_manifest;
+	std::vector<AnimationId> m_reloadedAnimations;
+
+	// Re-adding a name reuses its slot, so ids handed out earlier stay valid.
+	template <typename Id, typename T>
+	static T& slot(std::deque<T>& table, std::unordered_map<std::string, Id>& ids, const std::string& name)
+	{
+		auto [it, added] = ids.try_emplace(name);
+		if (added)
+		{
+			it->second.index = static_cast<uint32_t>(table.size());
+			table.emplace_back();
+		}
+		return table[it->second.index];
+	}
+
+	template <typename Id>
+	static Id resolve(const std::unordered_map<std::string, Id>& ids, const std::string& name, const char* kind)
+	{
+		auto it = ids.find(name);
+		if (it == ids.end())
+		{
+			std::cerr << "Unknown " << kind << ": " << name << std::endl;
+			assert(!"unknown asset name");
+			return Id();
+		}
+		return it->second;
+	}
+
+	static DecodedSound decodeSound(const std::string& path)
+	{
+		DecodedSound decoded;
+		sf::InputSoundFile file;
+		if (!file.openFromFile(path))
+			return decoded;
+
+		decoded.samples.resize(static_cast<size_t>(file.getSampleCount()));
+		decoded.ok = file.read(decoded.samples.data(), decoded.samples.size()) == decoded.samples.size();
+		decoded.channelMap = file.getChannelMap();
+		decoded.channels = file.getChannelCount();
+		decoded.sampleRate = file.getSampleRate();
+		return decoded;
+	}
+
+	void loadSound(SoundAsset& sound)
+	{
+		sound.buffer = sf::SoundBuffer();
+		bool ok = false;
+		if (sound.decoding.valid())
+		{
+			auto decoded = sound.decoding.get();
+			ok = decoded.ok && sound.buffer.loadFromSamples(decoded.samples.data(),
+				decoded.samples.size(), decoded.channels, decoded.sampleRate, decoded.channelMap);
+		}
+		else if (sound.packEntry)
+		{
+			auto& entry = *sound.packEntry;
+			const uint8_t* data = m_pack.data(entry);
+			unsigned int channels = entry.params[0];
+			std::vector<sf::SoundChannel> channelMap(channels);
+			for (unsigned int c = 0; c < channels; c++)
+				channelMap[c] = static_cast<sf::SoundChannel>(data[c]);
+
+			auto samples = reinterpret_cast<const int16_t*>(data + AssetPack::SoundChannelBytes);
+			uint64_t sampleCount = (entry.size - AssetPack::SoundChannelBytes) / sizeof(int16_t);
+			ok = sound.buffer.loadFromSamples(samples, sampleCount, channels, entry.params[1], channelMap);
+		}
+		else
+		{
+			ok = sound.buffer.loadFromFile(sound.source);
+		}
+
+		if (!ok)
+		{
+			std::cerr << "Could not load sound: " << sound.source << std::endl;
+		}
+
+		// a failed load still counts as loaded so it is not retried every play
+		sound.loaded = true;
+		sound.bytes = static_cast<size_t>(sound.buffer.getSampleCount()) * sizeof(int16_t);
+		m_soundBytes += sound.bytes;
+		evictSounds(sound);
+	}
+
+	void unloadSound(SoundAsset& sound)
+	{
+		sound.decoding = {};
+		sound.buffer = sf::SoundBuffer();
+		sound.loaded = false;
+		m_soundBytes -= sound.bytes;
+		sound.bytes = 0;
+	}
+
+	// Drop least recently played buffers until the budget fits. Voices still
+	// using an evicted buffer are stopped by SFML.
+	void evictSounds(const SoundAsset& keep)
+	{
+		while (m_soundBytes > m_soundBudget)
+		{
+			SoundAsset* oldest = nullptr;
+			for (auto& sound : m_sounds)
+			{
+				if (!sound.loaded || &sound == &keep)
+					continue;
+				if (!oldest || sound.lastUse < oldest->lastUse)
+					oldest = &sound;
+			}
+			if (!oldest)
+				return;
+			unloadSound(*oldest);
+		}
+	}
+
+	// Any stopped stream can be reopened later, so close those before
+	// opening another; paused ones keep their position.
+	void closeStoppedMusic()
+	{
+		for (auto it = m_musicMap.begin(); it != m_musicMap.end();)
+		{
+			if (it->second.getStatus() == sf::SoundSource::Status::Stopped)
+				it = m_musicMap.erase(it);
+			else
+				++it;
+		}
+	}
+
+	void finishAsset(PendingAsset& pending)
+	{
+		auto& asset = pending.asset;
+		if (asset.type == "Texture")
+		{
+			auto decoded = pending.image.get();
+			m_textureMap[asset.name] = sf::Texture();
+			if (!decoded.ok || !m_textureMap[asset.name].loadFromImage(decoded.image))
+			{
+				std::cerr << "Could not load texture from file: " << asset.path << std::endl;
+			}
+		}
+		else
+		{
+			addAsset(asset);
+			if (pending.reload && asset.type == "Animation")
+				m_reloadedAnimations.push_back(m_animationIds[asset.name]);
+		}
+	}
+
+	void watchManifest()
+	{
+		m_watcher.clear();
+		m_watcher.watch(m_manifestPath);
+		for (auto& asset : m_manifest)
+		{
+			if (asset.type == "Texture" || asset.type == "Sound")
+				m_watcher.watch(asset.path);
+		}
+	}
+
+	void queueAsset(const AssetManifestEntry& asset, ThreadPool& pool, bool reload)
+	{
+		PendingAsset pending;
+		pending.asset = asset;
+		pending.reload = reload;
+		if (asset.type == "Texture")
+		{
+			std::string file = asset.path;
+			pending.image = pool.submit([file]
+			{
+				DecodedImage decoded;
+				decoded.ok = decoded.image.loadFromFile(file);
+				return decoded;
+			});
+		}
+		m_pending.push_back(std::move(pending));
+		m_loadTotal++;
+	}
+
+	static bool sameAsset(const AssetManifestEntry& a, const AssetManifestEntry& b)
+	{
+		return a.type == b.type && a.name == b.name && a.path == b.path &&
+			a.rows == b.rows && a.cols == b.cols && a.frames == b.frames && a.speed == b.speed &&
+			a.maxInstances == b.maxInstances && a.priority == b.priority;
+	}
+
 public:
 	std::unordered_map<std::string, sf::Texture> m_textureMap;
-	std::unordered_map<std::string, Animation> m_animationMap;
-	std::unordered_map<std::string, sf::Font> m_fontMap;
-	std::unordered_map<std::string, sf::SoundBuffer> m_soundBufferMap;
-	std::unordered_map<std::string, sf::Sound> m_soundMap;
-	std::unordered_map<std::string, sf::Music> m_musicMap;
+	std::unordered_map<std::string, MusicSource> m_musicSources;
+	std::unordered_map<std::string, sf::Music> m_musicMap; // open streams only
+
+	// looked up every frame, so these are indexed by id rather than by name
+	std::deque<Animation> m_animations;
+	std::deque<sf::Font> m_fonts;
+	std::deque<SoundAsset> m_sounds;
+	std::unordered_map<std::string, AnimationId> m_animationIds;
+	std::unordered_map<std::string, FontId> m_fontIds;
+	std::unordered_map<std::string, SoundId> m_soundIds;
 
 	void addTexture(const std::string& textureName, const std::string& path,
 		bool smooth = false)
@@ -33,14 +290,16 @@ public:
 	void addAnimation(const std::string& animationName, const std::string& textureName,
 		size_t rows, size_t cols, size_t frameCount, size_t speed)
 	{
-		m_animationMap[animationName] = Animation(animationName, m_textureMap[textureName],
-			rows, cols, frameCount, speed);
+		auto& animation = slot(m_animations, m_animationIds, animationName);
+		animation = Animation(animationName, m_textureMap[textureName], rows, cols, frameCount, speed);
+		animation.m_id = m_animationIds[animationName];
 	}
 
 	void addFont(const std::string& fontName, const std::string& path)
 	{
-		m_fontMap[fontName] = sf::Font();
-		if (!m_fontMap[fontName].openFromFile(path))
+		auto& font = slot(m_fonts, m_fontIds, fontName);
+		font = sf::Font();
+		if (!font.openFromFile(path))
 		{
 			std::cerr << "Could not load font file: " << path << std::endl;
 		}
@@ -48,68 +307,332 @@ public:
 
 	void addSound(const std::string& soundName, const std::string& path)
 	{
-		m_soundBufferMap[soundName] = sf::SoundBuffer();
-		if (!m_soundBufferMap[soundName].loadFromFile(path))
-		{
-			std::cerr << "Could not load sound file: " << path << std::endl;
-		}
-		m_soundMap.emplace(soundName, sf::Sound(m_soundBufferMap[soundName]));
+		auto& sound = slot(m_sounds, m_soundIds, soundName);
+		unloadSound(sound);
+		sound.source = path;
+		sound.packEntry = nullptr;
+	}
+
+	void addVoice(const std::string& soundName, size_t maxInstances, int priority)
+	{
+		auto& settings = slot(m_sounds, m_soundIds, soundName).settings;
+		settings.maxInstances = maxInstances;
+		settings.priority = priority;
 	}
 
 	void addMusic(const std::string& musicName, const std::string& path)
 	{
-		m_musicMap[musicName] = sf::Music();
-		if (!m_musicMap[musicName].openFromFile(path))
+		m_musicMap.erase(musicName);
+		m_musicSources[musicName] = { path };
+	}
+	
+	void addAsset(const AssetManifestEntry& asset)
+	{
+		if (asset.type == "Texture")
 		{
-			std::cerr << "Could not load music file: " << path << std::endl;
+			addTexture(asset.name, asset.path);
+		}
+		else if (asset.type == "Animation")
+		{
+			addAnimation(asset.name, asset.path, asset.rows, asset.cols, asset.frames, asset.speed);
+		}
+		else if (asset.type == "Font")
+		{
+			addFont(asset.name, asset.path);
+		}
+		else if (asset.type == "Sound")
+		{
+			addSound(asset.name, asset.path);
+		}
+		else if (asset.type == "Voice")
+		{
+			addVoice(asset.name, asset.maxInstances, asset.priority);
+		}
+		else if (asset.type == "Music")
+		{
+			addMusic(asset.name, asset.path);
 		}
 	}
-	
+
 	Assets() = default;
 	void loadFromFile(const std::string& path)
 	{
-		auto file = std::ifstream(path);
-		std::string str;
-		while (file.good())
+		for (auto& asset : parseAssetManifest(path))
 		{
-			file >> str;
-			if (str == "Texture")
+			addAsset(asset);
+		}
+	}
+
+	// Start decoding the manifest on the pool. The assets named in first (and
+	// the textures their animations use) are queued ahead of everything else;
+	// call update() every frame to move finished ones onto the GPU.
+	void loadAsync(const std::string& path, ThreadPool& pool, const std::vector<std::string>& first)
+	{
+		auto manifest = parseAssetManifest(path);
+		std::unordered_set<std::string> firstNames(first.begin(), first.end());
+		std::vector<bool> queued(manifest.size(), false);
+		std::vector<size_t> order;
+
+		auto queue = [&](size_t i)
+		{
+			if (queued[i])
+				return;
+			queued[i] = true;
+			order.push_back(i);
+		};
+
+		for (size_t i = 0; i < manifest.size(); i++)
+		{
+			if (firstNames.count(manifest[i].name) == 0)
+				continue;
+			if (manifest[i].type == "Animation")
 			{
-				std::string name, path;
-				file >> name >> path;
-				addTexture(name, path);
+				for (size_t t = 0; t < manifest.size(); t++)
+				{
+					if (manifest[t].type == "Texture" && manifest[t].name == manifest[i].path)
+						queue(t);
+				}
 			}
-			else if (str == "Animation")
+			queue(i);
+		}
+		m_priorityCount = order.size();
+		for (size_t i = 0; i < manifest.size(); i++)
+		{
+			queue(i);
+		}
+
+		m_loadTotal = 0;
+		m_loadDone = 0;
+		for (size_t i : order)
+		{
+			queueAsset(manifest[i], pool, false);
+		}
+	}
+
+	// Finish queued assets in order until one is still decoding or the time
+	// budget runs out. With block set, wait for everything instead.
+	void update(float budgetMs, bool block = false)
+	{
+		sf::Clock clock;
+		while (!m_pending.empty())
+		{
+			auto& pending = m_pending.front();
+			bool decoding = pending.image.valid() &&
+				pending.image.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+			if (decoding && !block)
+				break;
+
+			finishAsset(pending);
+			m_pending.pop_front();
+			m_loadDone++;
+
+			if (!block && clock.getElapsedTime().asMilliseconds() >= budgetMs)
+				break;
+		}
+
+		// prefetched sounds that finished decoding
+		for (size_t i = 0; i < m_soundsDecoding.size();)
+		{
+			auto& sound = m_sounds[m_soundsDecoding[i]];
+			if (sound.decoding.valid() &&
+				sound.decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				i++;
+				continue;
+			}
+			if (sound.decoding.valid())
+				loadSound(sound);
+			m_soundsDecoding[i] = m_soundsDecoding.back();
+			m_soundsDecoding.pop_back();
+		}
+	}
+
+	void finishLoading()
+	{
+		update(0, true);
+	}
+
+	bool loadingDone() const
+	{
+		return m_pending.empty();
+	}
+
+	bool priorityDone() const
+	{
+		return m_loadDone >= m_priorityCount;
+	}
+
+	float loadProgress() const
+	{
+		return m_loadTotal == 0 ? 1.f : static_cast<float>(m_loadDone) / m_loadTotal;
+	}
+
+	// Watch the manifest and the texture and sound files it lists. Changed
+	// entries go back through the loader queue, so textures decode on the
+	// pool and nothing unrelated is touched.
+	void enableHotReload(const std::string& manifestPath, ThreadPool& pool)
+	{
+		m_reloadPool = &pool;
+		m_manifestPath = FileWatcher::normalize(manifestPath);
+		m_manifest = parseAssetManifest(manifestPath);
+		watchManifest();
+	}
+
+	void pollHotReload()
+	{
+		if (!m_reloadPool)
+			return;
+		auto changed = m_watcher.poll();
+		if (changed.empty())
+			return;
+
+		std::unordered_set<std::string> changedFiles(changed.begin(), changed.end());
+		bool manifestChanged = changedFiles.count(m_manifestPath) > 0;
+		auto manifest = manifestChanged ? parseAssetManifest(m_manifestPath) : m_manifest;
+
+		std::unordered_map<std::string, const AssetManifestEntry*> previous;
+		for (auto& asset : m_manifest)
+		{
+			previous[asset.type + " " + asset.name] = &asset;
+		}
+		auto edited = [&](const AssetManifestEntry& asset)
+		{
+			auto it = previous.find(asset.type + " " + asset.name);
+			return it == previous.end() || !sameAsset(*it->second, asset);
+		};
+
+		// textures first so the animations that use them are rebuilt after
+		std::unordered_set<std::string> reloadedTextures;
+		for (auto& asset : manifest)
+		{
+			if (asset.type == "Animation")
+				continue;
+			bool fileChanged = (asset.type == "Texture" || asset.type == "Sound") &&
+				changedFiles.count(FileWatcher::normalize(asset.path)) > 0;
+			if (!fileChanged && !edited(asset))
+				continue;
+			if (asset.type == "Texture")
+				reloadedTextures.insert(asset.name);
+			queueAsset(asset, *m_reloadPool, true);
+		}
+		for (auto& asset : manifest)
+		{
+			if (asset.type == "Animation" && (edited(asset) || reloadedTextures.count(asset.path)))
+				queueAsset(asset, *m_reloadPool, true);
+		}
+
+		if (manifestChanged)
+		{
+			m_manifest = std::move(manifest);
+			watchManifest();
+		}
+	}
+
+	// animations rebuilt since the last call, for scenes to swap in
+	std::vector<AnimationId> takeReloadedAnimations()
+	{
+		auto ids = std::move(m_reloadedAnimations);
+		m_reloadedAnimations.clear();
+		return ids;
+	}
+
+	// A pack built with --build-pack is only used while it is newer than the
+	// manifest and every file the manifest lists; rebuild it after changing
+	// assets. Sources that are missing don't count, the pack still has them.
+	static bool packIsCurrent(const std::string& manifestPath, const std::string& packPath)
+	{
+		std::error_code ec;
+		auto packTime = std::filesystem::last_write_time(packPath, ec);
+		if (ec)
+			return false;
+		auto manifestTime = std::filesystem::last_write_time(manifestPath, ec);
+		if (ec)
+			return true;
+		if (manifestTime > packTime)
+		{
+			std::cerr << "Asset pack is older than " << manifestPath << ", loading from files" << std::endl;
+			return false;
+		}
+
+		for (auto& asset : parseAssetManifest(manifestPath))
+		{
+			if (asset.type != "Texture" && asset.type != "Font" &&
+				asset.type != "Sound" && asset.type != "Music")
+				continue;
+			auto sourceTime = std::filesystem::last_write_time(asset.path, ec);
+			if (!ec && sourceTime > packTime)
+			{
+				std::cerr << "Asset pack is older than " << asset.path << ", loading from files" << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Fonts and music keep streaming from the mapping, so the pack stays open
+	// for as long as the assets are alive.
+	bool loadFromPack(const std::string& manifestPath, const std::string& path)
+	{
+		if (!m_pack.open(path, parseAssetManifest(manifestPath)))
+			return false;
+
+		for (size_t i = 0; i < m_pack.entryCount(); i++)
+		{
+			auto& entry = m_pack.entry(i);
+			std::string name = entry.name;
+			const uint8_t* data = m_pack.data(entry);
+
+			switch (entry.type)
+			{
+			case AssetPack::EntryType::Texture:
 			{
-				std::string name, texture;
-				size_t rows, cols;
-				size_t frames, speed;
-				file >> name >> texture >> rows >> cols >> frames >> speed;
-				addAnimation(name, texture, rows, cols, frames, speed);
+				m_textureMap[name] = sf::Texture();
+				if (!m_textureMap[name].resize({ entry.params[0], entry.params[1] }))
+				{
+					std::cerr << "Could not create packed texture: " << name << std::endl;
+					break;
+				}
+				m_textureMap[name].update(data);
+				break;
 			}
-			else if (str == "Font")
+			case AssetPack::EntryType::Animation:
 			{
-				std::string name, path;
-				file >> name >> path;
-				addFont(name, path);
+				std::string textureName(reinterpret_cast<const char*>(data), entry.size);
+				addAnimation(name, textureName, entry.params[0], entry.params[1], entry.params[2], entry.params[3]);
+				break;
 			}
-			else if (str == "Sound")
+			case AssetPack::EntryType::Font:
 			{
-				std::string name, path;
-				file >> name >> path;
-				addSound(name, path);
+				auto& font = slot(m_fonts, m_fontIds, name);
+				font = sf::Font();
+				if (!font.openFromMemory(data, entry.size))
+				{
+					std::cerr << "Could not open packed font: " << name << std::endl;
+				}
+				break;
 			}
-			else if (str == "Music")
+			case AssetPack::EntryType::Sound:
 			{
-				std::string name, path;
-				file >> name >> path;
-				addMusic(name, path);
+				auto& sound = slot(m_sounds, m_soundIds, name);
+				unloadSound(sound);
+				sound.source = name;
+				sound.packEntry = &entry;
+				break;
 			}
-			else
+			case AssetPack::EntryType::Music:
+			{
+				m_musicMap.erase(name);
+				m_musicSources[name] = { name, data, static_cast<size_t>(entry.size) };
+				break;
+			}
+			case AssetPack::EntryType::Voice:
 			{
-				std::cerr << "Unknown Asset Type: " << str << std::endl;
+				addVoice(name, entry.params[0], static_cast<int>(entry.params[1]));
+				break;
+			}
 			}
 		}
+		return true;
 	}
 
 	const sf::Texture& getTexture(const std::string& textureName) const
@@ -118,27 +641,146 @@ public:
 		return m_textureMap.at(textureName);
 	}
 
+	// Resolve once at scene init; an unknown name asserts here rather than
+	// on first use in the middle of a frame.
+	AnimationId animationId(const std::string& animationName) const
+	{
+		return resolve(m_animationIds, animationName, "animation");
+	}
+
+	// for names read from data files: invalid instead of asserting
+	AnimationId findAnimationId(const std::string& animationName) const
+	{
+		auto it = m_animationIds.find(animationName);
+		return it == m_animationIds.end() ? AnimationId() : it->second;
+	}
+
+	FontId fontId(const std::string& fontName) const
+	{
+		return resolve(m_fontIds, fontName, "font");
+	}
+
+	SoundId soundId(const std::string& soundName) const
+	{
+		return resolve(m_soundIds, soundName, "sound");
+	}
+
+	const Animation& getAnimation(AnimationId id) const
+	{
+		assert(id.index < m_animations.size());
+		return m_animations[id.index];
+	}
+
+	const sf::Font& getFont(FontId id) const
+	{
+		assert(id.index < m_fonts.size());
+		return m_fonts[id.index];
+	}
+
+	// Loads the buffer on first use, waiting for a prefetch that is still
+	// decoding, and marks it as recently played.
+	const sf::SoundBuffer& getSoundBuffer(SoundId id)
+	{
+		assert(id.index < m_sounds.size());
+		auto& sound = m_sounds[id.index];
+		sound.lastUse = ++m_soundClock;
+		if (!sound.loaded)
+			loadSound(sound);
+		return sound.buffer;
+	}
+
+	// Start decoding a scene's sounds on the pool so the first play does not
+	// stall. Packed sounds are only a copy, so they load right away.
+	void prefetchSounds(const std::vector<SoundId>& ids, ThreadPool& pool)
+	{
+		for (auto id : ids)
+		{
+			assert(id.index < m_sounds.size());
+			auto& sound = m_sounds[id.index];
+			sound.lastUse = ++m_soundClock;
+			if (sound.loaded || sound.decoding.valid())
+				continue;
+
+			if (sound.packEntry)
+			{
+				loadSound(sound);
+				continue;
+			}
+			std::string file = sound.source;
+			sound.decoding = pool.submit([file] { return decodeSound(file); });
+			m_soundsDecoding.push_back(id.index);
+		}
+	}
+
+	void setSoundBudget(size_t bytes)
+	{
+		m_soundBudget = bytes;
+	}
+
+	const SoundSettings& getSoundSettings(SoundId id) const
+	{
+		assert(id.index < m_sounds.size());
+		return m_sounds[id.index].settings;
+	}
+
 	const Animation& getAnimation(const std::string& animationName) const
 	{
-		assert(m_animationMap.find(animationName) != m_animationMap.end());
-		return m_animationMap.at(animationName);
+		return getAnimation(animationId(animationName));
 	}
 
 	const sf::Font& getFont(const std::string& fontName) const
 	{
-		assert(m_fontMap.find(fontName) != m_fontMap.end());
-		return m_fontMap.at(fontName);
+		return getFont(fontId(fontName));
 	}
 
-	sf::Sound& getSound(const std::string& soundName)
+	const sf::SoundBuffer& getSoundBuffer(const std::string& soundName)
 	{
-		assert(m_soundMap.find(soundName) != m_soundMap.end());
-		return m_soundMap.at(soundName);
+		return getSoundBuffer(soundId(soundName));
 	}
 
+	const SoundSettings& getSoundSettings(const std::string& soundName) const
+	{
+		return getSoundSettings(soundId(soundName));
+	}
+
+	// Streams are opened the first time a scene asks for them.
 	sf::Music& getMusic(const std::string& musicName)
 	{
-		assert(m_musicMap.find(musicName) != m_musicMap.end());
-		return m_musicMap.at(musicName);
+		auto it = m_musicMap.find(musicName);
+		if (it != m_musicMap.end())
+			return it->second;
+
+		auto source = m_musicSources.find(musicName);
+		assert(source != m_musicSources.end());
+		closeStoppedMusic();
+
+		auto& music = m_musicMap[musicName];
+		auto& src = source->second;
+		bool ok = src.data ? music.openFromMemory(src.data, src.size) : music.openFromFile(src.path);
+		if (!ok)
+		{
+			std::cerr << "Could not open music: " << src.path << std::endl;
+		}
+		return music;
+	}
+
+	void printMemoryReport(std::ostream& out) const
+	{
+		size_t textureBytes = 0;
+		for (auto& [name, texture] : m_textureMap)
+		{
+			textureBytes += size_t(texture.getSize().x) * texture.getSize().y * 4;
+		}
+		size_t soundsLoaded = 0;
+		for (auto& sound : m_sounds)
+		{
+			soundsLoaded += sound.loaded;
+		}
+
+		const float MB = 1024.f * 1024.f;
+		out << "Assets resident: textures " << textureBytes / MB << " MB (" << m_textureMap.size()
+			<< "), sounds " << m_soundBytes / MB << " / " << m_soundBudget / MB << " MB ("
+			<< soundsLoaded << " of " << m_sounds.size() << "), music streams open "
+			<< m_musicMap.size() << " of " << m_musicSources.size() << std::endl;
 	}
 };
\ No newline at end of file
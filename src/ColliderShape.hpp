@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Vec2.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+enum class ShapeType : uint8_t
+{
+	Box,
+	Circle,
+	Capsule,
+	OrientedBox
+};
+
+// Narrow-phase shape, centred on the entity. CBoundingBox::halfSize stays the
+// axis-aligned box around it, which is what the broad-phase tests; a Box
+// shape takes its extents from there.
+struct ColliderShape
+{
+	ShapeType type = ShapeType::Box;
+	Vec2f axis = { 1, 0 };      // capsule segment / oriented box x axis, unit length
+	float radius = 0;           // circle and capsule
+	float halfLength = 0;       // capsule segment, along axis
+	Vec2f halfExtents;          // oriented box, along axis and axis.perp()
+
+	static ColliderShape box()
+	{
+		return ColliderShape();
+	}
+
+	static ColliderShape circle(float radius)
+	{
+		ColliderShape shape;
+		shape.type = ShapeType::Circle;
+		shape.radius = radius;
+		return shape;
+	}
+
+	// angle in degrees, like CTransform::angle
+	static ColliderShape capsule(float halfLength, float radius, float angle)
+	{
+		ColliderShape shape;
+		shape.type = ShapeType::Capsule;
+		shape.axis = axisFor(angle);
+		shape.halfLength = halfLength;
+		shape.radius = radius;
+		return shape;
+	}
+
+	static ColliderShape orientedBox(const Vec2f& halfExtents, float angle)
+	{
+		ColliderShape shape;
+		shape.type = ShapeType::OrientedBox;
+		shape.axis = axisFor(angle);
+		shape.halfExtents = halfExtents;
+		return shape;
+	}
+
+	// half size of the smallest axis-aligned box that holds the shape
+	Vec2f boundingHalfSize() const
+	{
+		switch (type)
+		{
+		case ShapeType::Circle:
+			return Vec2f(radius, radius);
+		case ShapeType::Capsule:
+			return Vec2f(std::abs(axis.x) * halfLength + radius, std::abs(axis.y) * halfLength + radius);
+		case ShapeType::OrientedBox:
+			return Vec2f(std::abs(axis.x) * halfExtents.x + std::abs(axis.y) * halfExtents.y,
+				std::abs(axis.y) * halfExtents.x + std::abs(axis.x) * halfExtents.y);
+		default:
+			return Vec2f(0, 0);
+		}
+	}
+
+	float angleDegrees() const
+	{
+		return std::atan2(axis.y, axis.x) * 180.0f / 3.14159f;
+	}
+
+private:
+	static Vec2f axisFor(float angle)
+	{
+		float radians = angle * 3.14159f / 180.0f;
+		return Vec2f(std::cos(radians), std::sin(radians));
+	}
+};
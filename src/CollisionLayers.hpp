@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+enum class CollisionLayer : uint8_t
+{
+	Player,
+	Enemy,
+	PlayerAttack,
+	Pickup,
+	Count
+};
+
+using CollisionMask = uint32_t;
+
+constexpr CollisionMask layerBit(CollisionLayer layer)
+{
+	return CollisionMask(1) << static_cast<uint32_t>(layer);
+}
+
+constexpr CollisionMask AllLayers = ~CollisionMask(0);
+
+// Which layer pairs are ever tested. The broad-phase asks this before
+// gathering a pair category, so a disabled pair costs nothing.
+class CollisionMatrix
+{
+	std::array<CollisionMask, static_cast<size_t>(CollisionLayer::Count)> m_rows = {};
+
+public:
+	void enable(CollisionLayer a, CollisionLayer b)
+	{
+		m_rows[static_cast<size_t>(a)] |= layerBit(b);
+		m_rows[static_cast<size_t>(b)] |= layerBit(a);
+	}
+
+	bool interacts(CollisionLayer a, CollisionLayer b) const
+	{
+		return (m_rows[static_cast<size_t>(a)] & layerBit(b)) != 0;
+	}
+
+	// the matrix allows the layers and each collider's mask accepts the other
+	bool interacts(CollisionLayer aLayer, CollisionMask aMask, CollisionLayer bLayer, CollisionMask bMask) const
+	{
+		return interacts(aLayer, bLayer) && (aMask & layerBit(bLayer)) && (bMask & layerBit(aLayer));
+	}
+};
@@ -2,6 +2,8 @@
 
 #include "Animation.hpp"
 #include "Assets.hpp"
+#include "ColliderShape.hpp"
+#include "CollisionLayers.hpp"
 #include "Vec2.hpp"
 #include "Entity.hpp"
 
@@ -43,17 +45,63 @@ public:
 	CMoveAtSameVelocity(std::shared_ptr<Entity> t) : target(t) {}
 };
 
+class CItem : public Component
+{
+public:
+	size_t gridHandle = 0;
+	bool awake = false;
+
+	CItem() = default;
+	CItem(size_t h) : gridHandle(h) {}
+};
+
 class CFollow : public Component
 {
 public:
 	std::shared_ptr<Entity> target = nullptr;
 	float steering_scale = 0.1f;
 	float speed = 1.0f;
+	Vec2f desired;          // velocity from the last re-aim
+	bool aimed = false;
 
 	CFollow() = default;
 	CFollow(std::shared_ptr<Entity> t, float s) : target(t), speed(s) {}
 };
 
+// which entry of the scene's enemy archetypes an enemy was stamped from
+class CArchetype : public Component
+{
+public:
+	size_t index = 0;
+
+	CArchetype() = default;
+	CArchetype(size_t i) : index(i) {}
+};
+
+// Simulation detail for an enemy, picked each tick from its distance to the
+// camera. Steering and integration run once every stride ticks and cover all
+// the ticks since the last step.
+class CSimLod : public Component
+{
+public:
+	size_t stride = 1;
+	size_t phase = 0;      // spreads the steps of one tier over the stride
+	size_t lastStep = 0;
+
+	CSimLod() = default;
+	CSimLod(size_t p, size_t frame) : phase(p), lastStep(frame) {}
+
+	bool due(size_t frame) const
+	{
+		return (frame + phase) % stride == 0;
+	}
+
+	float steps(size_t frame) const
+	{
+		return static_cast<float>(std::max<size_t>(frame - lastStep, 1));
+	}
+};
+
 class CHealth : public Component
 {
 public:
@@ -61,6 +109,7 @@ public:
 	int maxHealth = 0;
 	int lastTakenDamage = 0;
 	int invulTime = 10;
+	bool invulnerable = false;
 
 	CHealth() = default;
 	CHealth(int h) : health(h), maxHealth(h) {}
@@ -109,6 +158,7 @@ public:
 	bool down = false;
 	bool displayHitbox = false;
 	bool autoAim = true;
+	float autoAimRange = 1000.0f;
 	bool autoAttack = true;
 	bool basicAttack = false;
 	bool specialAttack = false;
@@ -125,6 +175,7 @@ class CBasicAttack : public Component
 public:
 	int cooldown = 50;
 	int lastAttackTime = 0;
+	bool ready = true;
 	float scale = 1.0f;
 	int duration = 15;
 	int health = 100;
@@ -144,6 +195,7 @@ class CSpecialAttack : public Component
 public:
 	int cooldown = 150;
 	int lastAttackTime = 0;
+	bool ready = true;
 	float scale = 1.0f;
 	int duration = 60;
 	int health = 150;
@@ -164,6 +216,7 @@ class CBulletAttack: public Component
 public:
 	int cooldown = 40;
 	int lastAttackTime = 0;
+	bool ready = true;
 	float scale = 2.0f;
 	int duration = 90;
 	int health = 50;
@@ -185,6 +238,7 @@ class CRingAttack : public Component
 public:
 	int cooldown = 500;
 	int lastAttackTime = 0;
+	bool ready = true;
 	float scale = 2.0f;
 	int duration = 300;
 	int health = 1000;
@@ -204,6 +258,7 @@ class CExplodeAttack : public Component
 public:
 	int cooldown = 100;
 	int lastAttackTime = 0;
+	bool ready = true;
 	float scale = 2.0f;
 	int duration = 25;
 	int health = 100;
@@ -223,6 +278,7 @@ class CWhirlAttack : public Component
 public:
 	int cooldown = 400;
 	int lastAttackTime = 0;
+	bool ready = true;
 	float scale = 2.0f;
 	int duration = 300;
 	int health = 1000;
@@ -255,6 +311,7 @@ class CKnockback : public Component
 public:
 	float magnitude = 0;
 	int duration = 0;
+	int endFrame = 0;
 	bool beingKnockedback = false;
 
 	CKnockback() = default;
@@ -267,10 +324,15 @@ class CBoundingBox : public Component
 public:
 	Vec2f size;
 	Vec2f halfSize;
+	CollisionLayer layer = CollisionLayer::Enemy;
+	CollisionMask mask = AllLayers; // layers this collider accepts contacts from
+	ColliderShape shape;
 
 	CBoundingBox() = default;
-	CBoundingBox(const Vec2f& s)
-		: size(s), halfSize(s / 2) { }
+	CBoundingBox(const Vec2f& s, CollisionLayer l, CollisionMask m = AllLayers)
+		: size(s), halfSize(s / 2), layer(l), mask(m) { }
+	CBoundingBox(const ColliderShape& sh, CollisionLayer l, CollisionMask m = AllLayers)
+		: size(sh.boundingHalfSize() * 2), halfSize(sh.boundingHalfSize()), layer(l), mask(m), shape(sh) { }
 };
 
 class CAnimation : public Component
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// One enemy type from assets/enemies.txt. Values that grow with the player's
+// level are a base plus a per-level step.
+struct EnemyArchetype
+{
+	std::string name;
+	std::string idle;       // animation names
+	std::string hit;
+	std::string death;
+	int health = 1;
+	int healthPerLevel = 0;
+	int damage = 0;
+	float speed = 1.0f;
+	float scale = 1.0f;
+	int score = 1;
+	int scorePerLevel = 0;
+	int spawnInterval = 0;  // frames at level 0, shortened 10% per level
+	int count = 1;          // enemies per wave
+	int countPerLevel = 0;
+
+	int healthAt(int level) const { return health + healthPerLevel * level; }
+	int scoreAt(int level) const { return score + scorePerLevel * level; }
+	int countAt(int level) const { return count + countPerLevel * level; }
+	int intervalAt(int level) const
+	{
+		return static_cast<int>(spawnInterval * std::pow(0.90f, level));
+	}
+};
+
+// Each archetype starts with "Enemy <name>" and lists its properties on the
+// following lines until the next one. An archetype with a missing or
+// malformed value is reported and left out; the rest of the file still loads.
+inline std::vector<EnemyArchetype> parseEnemyArchetypes(const std::string& path)
+{
+	std::vector<EnemyArchetype> archetypes;
+	auto file = std::ifstream(path);
+	if (!file)
+	{
+		std::cerr << "Could not open enemy archetypes: " << path << std::endl;
+		return archetypes;
+	}
+
+	bool broken = false;
+	auto finish = [&]()
+	{
+		if (broken)
+			archetypes.pop_back();
+		broken = false;
+	};
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream ss(line);
+		std::string str;
+		if (!(ss >> str))
+			continue;
+
+		if (str == "Enemy")
+		{
+			finish();
+			archetypes.emplace_back();
+			ss >> archetypes.back().name;
+			continue;
+		}
+		if (archetypes.empty())
+		{
+			std::cerr << "Enemy property before any Enemy: " << str << std::endl;
+			continue;
+		}
+
+		auto& enemy = archetypes.back();
+		if (str == "Animations")
+			ss >> enemy.idle >> enemy.hit >> enemy.death;
+		else if (str == "Health")
+			ss >> enemy.health >> enemy.healthPerLevel;
+		else if (str == "Damage")
+			ss >> enemy.damage;
+		else if (str == "Speed")
+			ss >> enemy.speed;
+		else if (str == "Scale")
+			ss >> enemy.scale;
+		else if (str == "Score")
+			ss >> enemy.score >> enemy.scorePerLevel;
+		else if (str == "Spawn")
+			ss >> enemy.spawnInterval >> enemy.count >> enemy.countPerLevel;
+		else
+			std::cerr << "Unknown enemy property: " << str << std::endl;
+
+		if (!ss)
+		{
+			std::cerr << "Bad " << str << " line for enemy " << enemy.name << " in " << path
+				<< ", skipping it: " << line << std::endl;
+			broken = true;
+		}
+	}
+	finish();
+	return archetypes;
+}
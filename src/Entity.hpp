@@ -28,9 +28,37 @@ using ComponentTuple = std::tuple<
 	CDamage,
 	CDisappearingText,
 	CFollow,
-	CMoveAtSameVelocity
+	CSimLod,
+	CArchetype,
+	CMoveAtSameVelocity,
+	CItem
 >;
 
+// A prebaked set of components. Entities made from it start as one copy of
+// the whole set instead of a component-by-component build.
+class EntityBlueprint
+{
+	friend class Entity;
+
+	ComponentTuple m_components;
+
+public:
+	template <typename T, typename... TArgs>
+	T& add(TArgs&&... mArgs)
+	{
+		auto& component = get<T>();
+		component = T(std::forward<TArgs>(mArgs)...);
+		component.exists = true;
+		return component;
+	}
+
+	template <typename T>
+	T& get()
+	{
+		return std::get<T>(m_components);
+	}
+};
+
 class Entity
 {
 	friend class EntityManager;
@@ -40,6 +68,7 @@ class Entity
 	std::string m_tag = "default";
 	size_t m_id = 0;
 
+	Entity() = default;
 	Entity(const std::string& tag, const std::string& name, const size_t& id)
 		: m_tag(tag), m_name(name), m_id(id) {}
 
@@ -56,6 +85,11 @@ public:
 		m_active = false;
 	}
 
+	void stamp(const EntityBlueprint& blueprint)
+	{
+		m_components = blueprint.m_components;
+	}
+
 	size_t id() const
 	{
 		return m_id;
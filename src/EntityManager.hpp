@@ -1,16 +1,35 @@
 #pragma once
 
 #include "Entity.hpp"
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
 using EntityVec = std::vector<std::shared_ptr<Entity>>;
 
+// The handles made by one addEntities call. Valid until the next add.
+class EntitySpan
+{
+	const std::shared_ptr<Entity>* m_first = nullptr;
+	size_t m_count = 0;
+
+public:
+	EntitySpan(const std::shared_ptr<Entity>* first, size_t count)
+		: m_first(first), m_count(count) {}
+
+	const std::shared_ptr<Entity>* begin() const { return m_first; }
+	const std::shared_ptr<Entity>* end() const { return m_first + m_count; }
+	size_t size() const { return m_count; }
+	const std::shared_ptr<Entity>& operator[](size_t i) const { return m_first[i]; }
+};
+
 class EntityManager
 {
 	EntityVec m_entities;
 	EntityVec m_entitiesToAdd;
 	std::unordered_map<std::string, EntityVec> m_entityMap;
+	std::vector<std::pair<std::string, size_t>> m_pendingTagCounts; // from addEntities, reserved at the flush
 	size_t m_totalEntities = 0;
 
 	void removeDeadEntities(EntityVec& vec)
@@ -29,11 +48,25 @@ class EntityManager
 		);
 	}
 
+	// make room for extra more entries, growing geometrically so repeated
+	// waves don't reallocate every time
+	static void reserveMore(EntityVec& vec, size_t extra)
+	{
+		if (vec.capacity() < vec.size() + extra)
+			vec.reserve(std::max(vec.size() + extra, vec.capacity() * 2));
+	}
+
 public:
 	EntityManager() = default;
 
 	void update()
 	{
+		reserveMore(m_entities, m_entitiesToAdd.size());
+		for (auto& [tag, count] : m_pendingTagCounts)
+		{
+			reserveMore(m_entityMap[tag], count);
+		}
+		m_pendingTagCounts.clear();
 		for (auto& entity : m_entitiesToAdd)
 		{
 			m_entities.push_back(entity);
@@ -56,6 +89,45 @@ public:
 		return entity;
 	}
 
+	std::shared_ptr<Entity> addEntity(const std::string& tag, const std::string& name,
+		const EntityBlueprint& blueprint)
+	{
+		auto entity = addEntity(tag, name);
+		entity->stamp(blueprint);
+		return entity;
+	}
+
+	// Count entities stamped from one blueprint, constructed side by side in a
+	// single pooled block. The handles share the block's one control block, so
+	// it is freed once the last of them is gone. Like addEntity, nothing that
+	// getEntities hands out changes until the next update().
+	EntitySpan addEntities(const std::string& tag, const std::string& name, size_t count,
+		const EntityBlueprint& blueprint)
+	{
+		size_t first = m_entitiesToAdd.size();
+		if (count == 0)
+			return EntitySpan(m_entitiesToAdd.data() + first, 0);
+
+		std::shared_ptr<Entity[]> block(new Entity[count]);
+		reserveMore(m_entitiesToAdd, count);
+		auto pending = std::find_if(m_pendingTagCounts.begin(), m_pendingTagCounts.end(),
+			[&](const auto& entry) { return entry.first == tag; });
+		if (pending == m_pendingTagCounts.end())
+			m_pendingTagCounts.emplace_back(tag, count);
+		else
+			pending->second += count;
+		for (size_t i = 0; i < count; i++)
+		{
+			Entity& entity = block[i];
+			entity.m_tag = tag;
+			entity.m_name = name;
+			entity.m_id = m_totalEntities++;
+			entity.stamp(blueprint);
+			m_entitiesToAdd.emplace_back(block, &entity);
+		}
+		return EntitySpan(m_entitiesToAdd.data() + first, count);
+	}
+
 	const EntityVec& getEntities()
 	{
 		return m_entities;
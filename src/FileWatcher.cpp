@@ -0,0 +1,125 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::~FileWatcher()
+{
+	clear();
+}
+
+std::string FileWatcher::normalize(const std::string& path)
+{
+	return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+void FileWatcher::clear()
+{
+#ifdef __linux__
+	if (m_fd >= 0)
+		::close(m_fd);
+#endif
+	m_fd = -1;
+	m_dirs.clear();
+	m_files.clear();
+}
+
+#ifdef __linux__
+
+// Editors often save by writing a new file and renaming it over the old one,
+// so the containing directory is watched rather than the file itself.
+void FileWatcher::watch(const std::string& path)
+{
+	std::string file = normalize(path);
+	if (!m_files.try_emplace(file).second)
+		return;
+
+	if (m_fd < 0)
+	{
+		m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_fd < 0)
+		{
+			std::cerr << "Could not start file watcher" << std::endl;
+			return;
+		}
+	}
+
+	std::string dir = std::filesystem::path(file).parent_path().generic_string();
+	if (dir.empty())
+		dir = ".";
+	for (auto& [wd, watched] : m_dirs)
+	{
+		if (watched == dir)
+			return;
+	}
+
+	int wd = inotify_add_watch(m_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd < 0)
+	{
+		std::cerr << "Could not watch directory: " << dir << std::endl;
+		return;
+	}
+	m_dirs[wd] = dir;
+}
+
+std::vector<std::string> FileWatcher::poll()
+{
+	std::vector<std::string> changed;
+	if (m_fd < 0)
+		return changed;
+
+	alignas(inotify_event) char buffer[4096];
+	while (true)
+	{
+		ssize_t length = read(m_fd, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		for (ssize_t i = 0; i < length;)
+		{
+			auto event = reinterpret_cast<const inotify_event*>(buffer + i);
+			i += sizeof(inotify_event) + event->len;
+
+			auto dir = m_dirs.find(event->wd);
+			if (dir == m_dirs.end() || event->len == 0)
+				continue;
+
+			std::string file = dir->second == "." ? event->name : dir->second + "/" + event->name;
+			if (m_files.count(file) && std::find(changed.begin(), changed.end(), file) == changed.end())
+				changed.push_back(file);
+		}
+	}
+	return changed;
+}
+
+#else
+
+void FileWatcher::watch(const std::string& path)
+{
+	std::error_code ec;
+	std::string file = normalize(path);
+	m_files[file] = std::filesystem::last_write_time(file, ec);
+}
+
+std::vector<std::string> FileWatcher::poll()
+{
+	std::vector<std::string> changed;
+	for (auto& [file, time] : m_files)
+	{
+		std::error_code ec;
+		auto now = std::filesystem::last_write_time(file, ec);
+		if (!ec && now != time)
+		{
+			time = now;
+			changed.push_back(file);
+		}
+	}
+	return changed;
+}
+
+#endif
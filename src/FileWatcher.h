@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reports watched files that changed on disk since the last poll. Uses
+// inotify on Linux and compares modification times elsewhere. Paths are
+// compared in normalized generic form.
+class FileWatcher
+{
+	std::unordered_map<std::string, std::filesystem::file_time_type> m_files;
+	std::unordered_map<int, std::string> m_dirs; // inotify watch -> directory
+	int m_fd = -1;
+
+public:
+	FileWatcher() = default;
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	static std::string normalize(const std::string& path);
+
+	void watch(const std::string& path);
+	void clear();
+
+	// never blocks; each changed path is reported once per poll
+	std::vector<std::string> poll();
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Vec2.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Grid of steering directions centred on a single target (the player).
+// Each cell points at the target, bent away from crowded neighbouring cells,
+// so every follower gets its heading and some spreading from one lookup.
+// The same pass buckets the crowd by cell, which lets collision only test
+// followers in nearby cells instead of every pair.
+class FlowField
+{
+	int   m_width = 0;
+	int   m_height = 0;
+	float m_cellSize = 0;
+	float m_spreadWeight = 0;
+	Vec2f m_origin;
+	Vec2f m_target;
+
+	std::vector<uint16_t> m_density;
+	std::vector<Vec2f>    m_flow;
+	std::vector<uint32_t> m_cellStart;
+	std::vector<uint32_t> m_items;
+	std::vector<uint32_t> m_itemCell;
+	std::vector<uint32_t> m_cursor;
+
+	int cellX(float x) const
+	{
+		return std::clamp(static_cast<int>(std::floor((x - m_origin.x) / m_cellSize)), 0, m_width - 1);
+	}
+
+	int cellY(float y) const
+	{
+		return std::clamp(static_cast<int>(std::floor((y - m_origin.y) / m_cellSize)), 0, m_height - 1);
+	}
+
+	bool inside(const Vec2f& pos) const
+	{
+		return pos.x >= m_origin.x && pos.y >= m_origin.y &&
+			pos.x < m_origin.x + m_width * m_cellSize &&
+			pos.y < m_origin.y + m_height * m_cellSize;
+	}
+
+	float density(int x, int y) const
+	{
+		x = std::clamp(x, 0, m_width - 1);
+		y = std::clamp(y, 0, m_height - 1);
+		return m_density[y * m_width + x];
+	}
+
+public:
+	FlowField(int width = 64, int height = 64, float cellSize = 32.f, float spreadWeight = 0.15f)
+		: m_width(width), m_height(height), m_cellSize(cellSize), m_spreadWeight(spreadWeight)
+		, m_density(width * height), m_flow(width * height), m_cellStart(width * height + 1)
+	{
+	}
+
+	// Bucket positions by cell (counting sort). Positions outside the grid
+	// are clamped into the border cells.
+	void bin(const std::vector<Vec2f>& positions)
+	{
+		std::fill(m_density.begin(), m_density.end(), 0);
+		std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+		m_itemCell.resize(positions.size());
+		m_items.resize(positions.size());
+
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			uint32_t cell = cellY(positions[i].y) * m_width + cellX(positions[i].x);
+			m_itemCell[i] = cell;
+			m_cellStart[cell + 1]++;
+			if (m_density[cell] < UINT16_MAX)
+				m_density[cell]++;
+		}
+		for (size_t c = 1; c < m_cellStart.size(); c++)
+		{
+			m_cellStart[c] += m_cellStart[c - 1];
+		}
+
+		m_cursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			m_items[m_cursor[m_itemCell[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	// Recentre on the target, bin the crowd and recompute every cell's heading.
+	void build(const Vec2f& target, const std::vector<Vec2f>& positions)
+	{
+		m_target = target;
+		Vec2f half = Vec2f(m_width * m_cellSize, m_height * m_cellSize) / 2;
+		m_origin = Vec2f(std::floor((target.x - half.x) / m_cellSize) * m_cellSize,
+			std::floor((target.y - half.y) / m_cellSize) * m_cellSize);
+
+		bin(positions);
+
+		for (int y = 0; y < m_height; y++)
+		{
+			for (int x = 0; x < m_width; x++)
+			{
+				Vec2f centre = m_origin + Vec2f((x + 0.5f) * m_cellSize, (y + 0.5f) * m_cellSize);
+				Vec2f seek = (target - centre).normalize();
+
+				// downhill on the density map, away from the crowd
+				Vec2f spread = Vec2f(density(x - 1, y) - density(x + 1, y),
+					density(x, y - 1) - density(x, y + 1));
+
+				m_flow[y * m_width + x] = (seek + spread * m_spreadWeight).normalize();
+			}
+		}
+	}
+
+	// unit heading for a follower at pos; outside the grid it seeks directly
+	Vec2f direction(const Vec2f& pos) const
+	{
+		if (!inside(pos))
+			return (m_target - pos).normalize();
+		return m_flow[cellY(pos.y) * m_width + cellX(pos.x)];
+	}
+
+	// number of cell rings that cover a distance
+	int cellsFor(float distance) const
+	{
+		return std::max(1, static_cast<int>(std::ceil(distance / m_cellSize)));
+	}
+
+	// call fn(begin, end) with the range of binnedItems() in each non-empty
+	// cell around pos
+	template <typename F>
+	void forEachCellNear(const Vec2f& pos, int rings, F&& fn) const
+	{
+		int cx = cellX(pos.x);
+		int cy = cellY(pos.y);
+		for (int y = std::max(0, cy - rings); y <= std::min(m_height - 1, cy + rings); y++)
+		{
+			for (int x = std::max(0, cx - rings); x <= std::min(m_width - 1, cx + rings); x++)
+			{
+				int cell = y * m_width + x;
+				if (m_cellStart[cell] < m_cellStart[cell + 1])
+					fn(static_cast<size_t>(m_cellStart[cell]), static_cast<size_t>(m_cellStart[cell + 1]));
+			}
+		}
+	}
+
+	// call fn(index) for every binned position in the cells around pos
+	template <typename F>
+	void forEachNear(const Vec2f& pos, int rings, F&& fn) const
+	{
+		forEachCellNear(pos, rings, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				fn(static_cast<size_t>(m_items[i]));
+			}
+		});
+	}
+
+	// position indices from the last bin(), grouped by cell
+	const std::vector<uint32_t>& binnedItems() const
+	{
+		return m_items;
+	}
+};
@@ -4,10 +4,13 @@
 #include "Scene_Play.h"
 #include "Scene_GameOver.h"
 #include "Scene_NewWeapon.h"
+#include "Scene_Loading.h"
 #include "Timer.hpp"
 
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <ctime>
 
 GameEngine::GameEngine(const std::string& path)
 {
@@ -16,18 +19,33 @@ GameEngine::GameEngine(const std::string& path)
 
 void GameEngine::init(const std::string& path)
 {
-	m_assets.loadFromFile(path);
-
 	sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
 	m_window.create(desktop, "Alien Survivor", sf::Style::None);
 	m_window.setFramerateLimit(60);
 
+	m_seed = static_cast<unsigned int>(time(nullptr));
+	m_random.seed(m_seed);
+
 	/*if (!ImGui::SFML::Init(m_window))
 	{
 		std::cerr << "Could not open window." << std::endl;
 	}*/
 
-	changeScene("MENU", std::make_shared<Scene_Menu>(this));
+	// A current pack loads in one go. Otherwise decode on the pool behind a
+	// loading screen, menu assets first, and keep streaming the rest in the
+	// background while the menu is up.
+	std::string packPath = std::filesystem::path(path).replace_extension(".pack").string();
+	if (Assets::packIsCurrent(path, packPath) && m_assets.loadFromPack(path, packPath))
+	{
+		changeScene("MENU", std::make_shared<Scene_Menu>(this));
+	}
+	else
+	{
+		m_assets.loadAsync(path, m_threadPool, Scene_Menu::requiredAssets());
+		changeScene("LOADING", std::make_shared<Scene_Loading>(this, "MENU",
+			[this] { return std::make_shared<Scene_Menu>(this); }, false));
+	}
+	m_assets.enableHotReload(path, m_threadPool);
 	//changeScene("PLAY", std::make_shared<Scene_Play>(this));
 	//changeScene("NEW_WEAPON", std::make_shared<Scene_NewWeapon>(this));
 }
@@ -56,7 +74,102 @@ void GameEngine::run()
 	}
 	//ImGui::SFML::Shutdown();
 	m_window.close();
-	
+
+	if (m_replayMode == ReplayMode::Record)
+	{
+		m_replay.end(static_cast<uint32_t>(m_frame));
+		if (m_replay.save(m_replayPath))
+			std::cout << "Saved replay (" << m_replay.eventCount() << " actions, "
+				<< m_frame << " frames) to " << m_replayPath << std::endl;
+	}
+}
+
+void GameEngine::recordReplay(const std::string& path)
+{
+	m_replayMode = ReplayMode::Record;
+	m_replayPath = path;
+	m_replaySize = m_window.getSize();
+	m_replay.begin(m_seed, m_replaySize.x, m_replaySize.y);
+
+	// streaming would make scene changes depend on disk speed
+	m_assets.finishLoading();
+}
+
+bool GameEngine::playReplay(const std::string& path, bool headless)
+{
+	if (!m_replay.load(path))
+		return false;
+
+	m_replayMode = ReplayMode::Playback;
+	m_replayPath = path;
+	m_headless = headless;
+	m_seed = m_replay.seed();
+	m_random.seed(m_seed);
+	m_replaySize = sf::Vector2u(m_replay.width(), m_replay.height());
+	m_assets.finishLoading();
+
+	if (m_headless)
+	{
+		m_window.setVisible(false);
+		m_window.setFramerateLimit(0);
+	}
+	return true;
+}
+
+void GameEngine::recordAction(const Action& action)
+{
+	if (m_replayMode == ReplayMode::Record)
+		m_replay.record(static_cast<uint32_t>(m_frame), action);
+}
+
+unsigned int GameEngine::seed() const
+{
+	return m_seed;
+}
+
+// recording or playing back a replay, which needs identical runs
+bool GameEngine::deterministic() const
+{
+	return m_replayMode != ReplayMode::None;
+}
+
+// Size scenes lay out and simulate at. Replays keep the size they were
+// recorded at, whatever the window is now, and headless runs have no
+// window size worth using.
+sf::Vector2u GameEngine::viewSize() const
+{
+	if (deterministic())
+		return m_replaySize;
+	return m_window.getSize();
+}
+
+RandomService& GameEngine::random()
+{
+	return m_random;
+}
+
+void GameEngine::sReplayInput()
+{
+	// live input is ignored during playback, but the window still has to be pumped
+	while (const std::optional event = m_window.pollEvent())
+	{
+		if (event->is<sf::Event::Closed>())
+			quit();
+	}
+
+	Action action;
+	while (m_replay.poll(static_cast<uint32_t>(m_frame), action))
+	{
+		currentScene()->doAction(action);
+	}
+}
+
+void GameEngine::printReplayStats() const
+{
+	std::cout << "Replay finished: " << m_frame << " frames, "
+		<< m_totalFrameMs << " ms total, "
+		<< m_totalFrameMs / std::max<size_t>(m_frame, 1) << " ms/frame avg, "
+		<< m_worstFrameMs << " ms worst (frame " << m_worstFrame << ")" << std::endl;
 }
 
 void GameEngine::sUserInput()
@@ -79,36 +192,22 @@ void GameEngine::sUserInput()
 
 		if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>())
 		{
-			if (currentScene()->getActionMap().find(keyPressed->scancode) ==
-				currentScene()->getActionMap().end())
+			ActionName name = currentScene()->getAction(keyPressed->scancode);
+			if (name == ActionName::NONE)
 			{
 				continue;
 			}
-			currentScene()->doAction
-			(
-				Action
-				(
-				currentScene()->getActionMap().at(keyPressed->scancode),
-				"START"
-				)
-			);
+			currentScene()->doAction(Action(name, ActionType::START));
 		}
 
 		if (const auto* keyReleased = event->getIf<sf::Event::KeyReleased>())
 		{
-			if (currentScene()->getActionMap().find(keyReleased->scancode) ==
-				currentScene()->getActionMap().end())
+			ActionName name = currentScene()->getAction(keyReleased->scancode);
+			if (name == ActionName::NONE)
 			{
 				continue;
 			}
-			currentScene()->doAction
-			(
-				Action
-				(
-					currentScene()->getActionMap().at(keyReleased->scancode),
-					"END"
-				)
-			);
+			currentScene()->doAction(Action(name, ActionType::END));
 		}
 
 		if (const auto* mousePressed = event->getIf<sf::Event::MouseButtonPressed>())
@@ -117,17 +216,17 @@ void GameEngine::sUserInput()
 			{
 			case sf::Mouse::Button::Left:
 			{
-				currentScene()->doAction(Action("LEFT_CLICK", "START", mousePressed->position));
+				currentScene()->doAction(Action(ActionName::LEFT_CLICK, ActionType::START, mousePressed->position));
 				break;
 			}
 			case sf::Mouse::Button::Middle:
 			{
-				currentScene()->doAction(Action("MIDDLE_CLICK", "START", mousePressed->position));
+				currentScene()->doAction(Action(ActionName::MIDDLE_CLICK, ActionType::START, mousePressed->position));
 				break;
 			}
 			case sf::Mouse::Button::Right:
 			{
-				currentScene()->doAction(Action("RIGHT_CLICK", "START", mousePressed->position));
+				currentScene()->doAction(Action(ActionName::RIGHT_CLICK, ActionType::START, mousePressed->position));
 				break;
 			}
 			default: break;
@@ -140,17 +239,17 @@ void GameEngine::sUserInput()
 			{
 			case sf::Mouse::Button::Left:
 			{
-				currentScene()->doAction(Action("LEFT_CLICK", "END", mouseReleased->position));
+				currentScene()->doAction(Action(ActionName::LEFT_CLICK, ActionType::END, mouseReleased->position));
 				break;
 			}
 			case sf::Mouse::Button::Middle:
 			{
-				currentScene()->doAction(Action("MIDDLE_CLICK", "END", mouseReleased->position));
+				currentScene()->doAction(Action(ActionName::MIDDLE_CLICK, ActionType::END, mouseReleased->position));
 				break;
 			}
 			case sf::Mouse::Button::Right:
 			{
-				currentScene()->doAction(Action("RIGHT_CLICK", "END", mouseReleased->position));
+				currentScene()->doAction(Action(ActionName::RIGHT_CLICK, ActionType::END, mouseReleased->position));
 				break;
 			}
 			default: break;
@@ -159,7 +258,7 @@ void GameEngine::sUserInput()
 
 		if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>())
 		{
-			currentScene()->doAction(Action("MOUSE_MOVE", "START", mouseMoved->position));
+			currentScene()->doAction(Action(ActionName::MOUSE_MOVE, ActionType::START, mouseMoved->position));
 		}
 	}
 }
@@ -167,7 +266,12 @@ void GameEngine::sUserInput()
 bool GameEngine::changeScene(const std::string& sceneName, std::shared_ptr<Scene> scene,
 	bool endCurrentScene)
 {
-	if (scene)
+	if (scene && scene->hasEnded())
+	{
+		std::cerr << "Scene failed to start: " << sceneName << std::endl;
+		return false;
+	}
+	else if (scene)
 	{
 		m_sceneMap[sceneName] = scene;
 	}
@@ -183,14 +287,42 @@ bool GameEngine::changeScene(const std::string& sceneName, std::shared_ptr<Scene
 	}
 	m_currentScene = sceneName;
 	m_sceneChanged = true;
+#ifndef NDEBUG
+	m_assets.printMemoryReport(std::cout);
+#endif
 	return true;
 }
 
+void GameEngine::sHotReload()
+{
+	// checking for changes is a syscall or a stat per file, so only twice a second
+	if (!m_headless && m_frame % 30 == 0)
+		m_assets.pollHotReload();
+
+	auto reloaded = m_assets.takeReloadedAnimations();
+	if (reloaded.empty())
+		return;
+	for (auto& [name, scene] : m_sceneMap)
+	{
+		scene->reloadAnimations(reloaded);
+	}
+}
+
 void GameEngine::quit()
 {
 	m_running = false;
 }
 
+SoundManager& GameEngine::sound()
+{
+	return m_sound;
+}
+
+ThreadPool& GameEngine::threadPool()
+{
+	return m_threadPool;
+}
+
 const Assets& GameEngine::assets() const
 {
 	return m_assets;
@@ -212,11 +344,37 @@ void GameEngine::update()
 		m_sceneChanged = false;
 	}
 
-	sUserInput();
+	m_frameClock.restart();
+	m_sound.update();
+	m_assets.update(4.0f);
+	sHotReload();
+
+	if (m_replayMode == ReplayMode::Playback)
+		sReplayInput();
+	else
+		sUserInput();
+
 	std::shared_ptr<Scene> curScene = currentScene();
 	curScene->simulate(m_simulationSpeed);
-	curScene->sRender();
+	if (!m_headless)
+		curScene->sRender();
+
+	double frameMs = m_frameClock.getElapsedTime().asMicroseconds() / 1000.0;
+	m_totalFrameMs += frameMs;
+	if (frameMs > m_worstFrameMs)
+	{
+		m_worstFrameMs = frameMs;
+		m_worstFrame = m_frame;
+	}
 
 	//ImGui::SFML::Render(m_window);
-	m_window.display();
+	if (!m_headless)
+		m_window.display();
+
+	m_frame++;
+	if (m_replayMode == ReplayMode::Playback && m_replay.finished(static_cast<uint32_t>(m_frame)))
+	{
+		printReplayStats();
+		quit();
+	}
 }
\ No newline at end of file
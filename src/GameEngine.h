@@ -2,6 +2,10 @@
 
 #include "Scene.h"
 #include "Assets.hpp"
+#include "Replay.hpp"
+#include "Random.hpp"
+#include "SoundManager.hpp"
+#include "ThreadPool.hpp"
 
 #include "imgui.h"
 #include "imgui-SFML.h"
@@ -12,10 +16,13 @@
 
 using SceneMap = std::unordered_map<std::string, std::shared_ptr<Scene>>;
 
+enum class ReplayMode { None, Record, Playback };
+
 class GameEngine
 {
 protected:
 	sf::RenderWindow m_window;
+	ThreadPool m_threadPool;
 	Assets m_assets;
 	std::string m_currentScene;
 	SceneMap m_sceneMap;
@@ -23,10 +30,27 @@ protected:
 	sf::Clock m_deltaClock;
 	bool m_running = true;
 	bool m_sceneChanged = false;
+	size_t m_frame = 0;
+	unsigned int m_seed = 0;
+	RandomService m_random;
+	SoundManager m_sound;
+
+	Replay m_replay;
+	ReplayMode m_replayMode = ReplayMode::None;
+	std::string m_replayPath;
+	sf::Vector2u m_replaySize;
+	bool m_headless = false;
+	sf::Clock m_frameClock;
+	double m_totalFrameMs = 0;
+	double m_worstFrameMs = 0;
+	size_t m_worstFrame = 0;
 
 	void init(const std::string& path);
 	void update();
 	void sUserInput();
+	void sReplayInput();
+	void sHotReload();
+	void printReplayStats() const;
 	std::shared_ptr<Scene> currentScene();
 
 public:
@@ -41,6 +65,16 @@ public:
 	void quit();
 	void run();
 
+	void recordReplay(const std::string& path);
+	bool playReplay(const std::string& path, bool headless = false);
+	void recordAction(const Action& action);
+	unsigned int seed() const;
+	bool deterministic() const;
+	sf::Vector2u viewSize() const;
+	RandomService& random();
+	SoundManager& sound();
+	ThreadPool& threadPool();
+
 	sf::RenderWindow& window();
 	const Assets& assets() const;
 	Assets& assets();
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file. The platform headers stay in the
+// .cpp so windows.h never leaks into the rest of the engine.
+class MappedFile
+{
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const;
+	const uint8_t* data() const;
+	size_t size() const;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Random.hpp"
+
 #include <SFML/Graphics.hpp>
 #include <vector>
 
@@ -15,6 +17,7 @@ class ParticleSystem
 	sf::VertexArray m_vertices;
 	sf::Vector2u m_windowSize;
 	float m_size = 8;
+	Rng m_rng;
 
 	void resetParticle(size_t index, bool firstSpawn = false)
 	{
@@ -38,11 +41,11 @@ class ParticleSystem
 		m_vertices[6 * index + 4].color = color;
 		m_vertices[6 * index + 5].color = color;
 
-		float rx = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-		float ry = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+		float rx = m_rng.uniform(-1.0f, 1.0f);
+		float ry = m_rng.uniform(-1.0f, 1.0f);
 		m_particles[index].velocity = sf::Vector2f(rx, ry);
 
-		m_particles[index].lifetime = 30 + rand() % 60;
+		m_particles[index].lifetime = 30 + m_rng.range(60);
 	}
 
 public:
@@ -60,9 +63,10 @@ public:
 		}
 	}
 
-	void init(sf::Vector2u windowSize)
+	void init(sf::Vector2u windowSize, const Rng& rng = Rng())
 	{
 		m_windowSize = windowSize;
+		m_rng = rng;
 		resetParticles();
 	}
 
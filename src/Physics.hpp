@@ -2,6 +2,16 @@
 
 #include "Entity.hpp"
 #include "Components.hpp"
+#include "Vec2Batch.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <cstdint>
+#include <vector>
 
 struct Intersect
 {
@@ -9,8 +19,158 @@ struct Intersect
 	Vec2f point;
 };
 
+// Boxes packed as separate min/max arrays so one box can be tested against
+// many in a single pass.
+struct AABBArray
+{
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+
+	size_t size() const
+	{
+		return minX.size();
+	}
+
+	void resize(size_t count)
+	{
+		minX.resize(count);
+		minY.resize(count);
+		maxX.resize(count);
+		maxY.resize(count);
+	}
+
+	void set(size_t i, const Vec2f& center, const Vec2f& halfSize)
+	{
+		minX[i] = center.x - halfSize.x;
+		minY[i] = center.y - halfSize.y;
+		maxX[i] = center.x + halfSize.x;
+		maxY[i] = center.y + halfSize.y;
+	}
+
+	// a box that overlaps nothing, for entities without a bounding box
+	void setEmpty(size_t i)
+	{
+		minX[i] = minY[i] = FLT_MAX;
+		maxX[i] = maxY[i] = -FLT_MAX;
+	}
+};
+
 class Physics
 {
+	static size_t LowestBit(uint64_t bits)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return index;
+#else
+		return static_cast<size_t>(__builtin_ctzll(bits));
+#endif
+	}
+
+	// p in the frame of a shape whose x axis is axis
+	static Vec2f ToLocal(const Vec2f& p, const Vec2f& axis)
+	{
+		return Vec2f(p.dot(axis), p.dot(axis.perp()));
+	}
+
+	static float PointBoxDistSquared(const Vec2f& p, const Vec2f& halfSize)
+	{
+		float dx = std::max(std::abs(p.x) - halfSize.x, 0.0f);
+		float dy = std::max(std::abs(p.y) - halfSize.y, 0.0f);
+		return dx * dx + dy * dy;
+	}
+
+	static float PointSegmentDistSquared(const Vec2f& p, const Vec2f& a, const Vec2f& b)
+	{
+		Vec2f ab = b - a;
+		float len2 = ab.lengthSquared();
+		float t = len2 > 0 ? std::clamp((p - a).dot(ab) / len2, 0.0f, 1.0f) : 0.0f;
+		return p.distToSquared(a + ab * t);
+	}
+
+	// slab test against a box centred on the origin
+	static bool SegmentHitsBox(const Vec2f& a, const Vec2f& b, const Vec2f& halfSize)
+	{
+		float tMin = 0, tMax = 1;
+		const float start[2] = { a.x, a.y };
+		const float delta[2] = { b.x - a.x, b.y - a.y };
+		const float half[2] = { halfSize.x, halfSize.y };
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (delta[axis] == 0)
+			{
+				if (std::abs(start[axis]) > half[axis])
+					return false;
+				continue;
+			}
+			float t1 = (-half[axis] - start[axis]) / delta[axis];
+			float t2 = (half[axis] - start[axis]) / delta[axis];
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+			if (tMin > tMax)
+				return false;
+		}
+		return true;
+	}
+
+	// Closest approach between a segment and a box centred on the origin. When
+	// they do not touch it is always at an endpoint or a box corner.
+	static float SegmentBoxDistSquared(const Vec2f& a, const Vec2f& b, const Vec2f& halfSize)
+	{
+		if (SegmentHitsBox(a, b, halfSize))
+			return 0;
+		float best = std::min(PointBoxDistSquared(a, halfSize), PointBoxDistSquared(b, halfSize));
+		for (float sx : { -1.0f, 1.0f })
+		{
+			for (float sy : { -1.0f, 1.0f })
+			{
+				best = std::min(best, PointSegmentDistSquared(Vec2f(sx * halfSize.x, sy * halfSize.y), a, b));
+			}
+		}
+		return best;
+	}
+
+	static float Cross(const Vec2f& a, const Vec2f& b)
+	{
+		return a.x * b.y - a.y * b.x;
+	}
+
+	static float SegmentSegmentDistSquared(const Vec2f& a1, const Vec2f& b1, const Vec2f& a2, const Vec2f& b2)
+	{
+		Vec2f d1 = b1 - a1;
+		Vec2f d2 = b2 - a2;
+		float s1 = Cross(d1, a2 - a1), s2 = Cross(d1, b2 - a1);
+		float s3 = Cross(d2, a1 - a2), s4 = Cross(d2, b1 - a2);
+		if (((s1 < 0 && s2 > 0) || (s1 > 0 && s2 < 0)) && ((s3 < 0 && s4 > 0) || (s3 > 0 && s4 < 0)))
+			return 0;
+		return std::min({ PointSegmentDistSquared(a1, a2, b2), PointSegmentDistSquared(b1, a2, b2),
+			PointSegmentDistSquared(a2, a1, b1), PointSegmentDistSquared(b2, a1, b1) });
+	}
+
+	// separating axis test over the four box axes
+	static bool BoxesOverlap(const Vec2f& delta, const Vec2f& aAxis, const Vec2f& aHalf,
+		const Vec2f& bAxis, const Vec2f& bHalf)
+	{
+		const Vec2f axes[4] = { aAxis, aAxis.perp(), bAxis, bAxis.perp() };
+		for (const Vec2f& n : axes)
+		{
+			float aReach = aHalf.x * std::abs(aAxis.dot(n)) + aHalf.y * std::abs(aAxis.perp().dot(n));
+			float bReach = bHalf.x * std::abs(bAxis.dot(n)) + bHalf.y * std::abs(bAxis.perp().dot(n));
+			if (std::abs(delta.dot(n)) >= aReach + bReach)
+				return false;
+		}
+		return true;
+	}
+
+	// capsule segment end points, relative to the capsule centre
+	static Vec2f CapsuleEnd(const ColliderShape& capsule)
+	{
+		return capsule.axis * capsule.halfLength;
+	}
+
 public:
 	Physics() = default;
 
@@ -57,4 +217,164 @@ public:
 		float yOverlap = aBB.halfSize.y + bBB.halfSize.y - delta.y;
 		return Vec2f(xOverlap, yOverlap);
 	}
+
+	// Bit (i - begin) of xHits and yHits is set when the query box overlaps
+	// boxes[i] on that axis, matching GetOverlap(...).x > 0 and .y > 0. Pass
+	// boxes built from prevPos for the GetPreviousOverlap equivalent.
+	void static AxisOverlapMasks(const Vec2f& center, const Vec2f& halfSize, const AABBArray& boxes,
+		size_t begin, size_t end, std::vector<uint64_t>& xHits, std::vector<uint64_t>& yHits)
+	{
+		size_t words = (end - begin + 63) / 64;
+		xHits.assign(words, 0);
+		yHits.assign(words, 0);
+
+		Vec2f qMin = center - halfSize;
+		Vec2f qMax = center + halfSize;
+		Vec2Batch::forEach(begin, end, [&](auto lanes, size_t i)
+		{
+			using F = decltype(lanes);
+			unsigned x = lessMask(F::set(qMin.x), F::load(&boxes.maxX[i])) &
+				lessMask(F::load(&boxes.minX[i]), F::set(qMax.x));
+			unsigned y = lessMask(F::set(qMin.y), F::load(&boxes.maxY[i])) &
+				lessMask(F::load(&boxes.minY[i]), F::set(qMax.y));
+			size_t bit = i - begin;
+			xHits[bit / 64] |= uint64_t(x) << (bit % 64);
+			yHits[bit / 64] |= uint64_t(y) << (bit % 64);
+		});
+	}
+
+	// Both axes at once; bit (i - begin) is set when the boxes intersect.
+	void static OverlapMask(const Vec2f& center, const Vec2f& halfSize, const AABBArray& boxes,
+		size_t begin, size_t end, std::vector<uint64_t>& hits)
+	{
+		static thread_local std::vector<uint64_t> yHits;
+		AxisOverlapMasks(center, halfSize, boxes, begin, end, hits, yHits);
+		for (size_t w = 0; w < hits.size(); w++)
+		{
+			hits[w] &= yHits[w];
+		}
+	}
+
+	bool static HasHit(const std::vector<uint64_t>& hits, size_t bit)
+	{
+		return (hits[bit / 64] >> (bit % 64)) & 1;
+	}
+
+	// A box of halfSize moving from start by travel, against a still box. The
+	// moving box shrinks to a point and the still one grows by its size, so
+	// this is a ray against an AABB. point is where the mover's centre is at
+	// first contact.
+	Intersect static SweepBox(const Vec2f& start, const Vec2f& travel, const Vec2f& halfSize,
+		const Vec2f& boxCenter, const Vec2f& boxHalfSize)
+	{
+		Vec2f reach = halfSize + boxHalfSize;
+		Vec2f from = start - boxCenter;
+		float tEnter = 0, tExit = 1;
+		const float origin[2] = { from.x, from.y };
+		const float delta[2] = { travel.x, travel.y };
+		const float half[2] = { reach.x, reach.y };
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (delta[axis] == 0)
+			{
+				if (std::abs(origin[axis]) >= half[axis])
+					return Intersect();
+				continue;
+			}
+			float inv = 1.0f / delta[axis];
+			float t1 = (-half[axis] - origin[axis]) * inv;
+			float t2 = (half[axis] - origin[axis]) * inv;
+			tEnter = std::max(tEnter, std::min(t1, t2));
+			tExit = std::min(tExit, std::max(t1, t2));
+			if (tEnter >= tExit)
+				return Intersect();
+		}
+		return { true, start + travel * tEnter };
+	}
+
+	// Exact test between two colliders, for pairs the broad-phase already
+	// matched on their bounding boxes. Touching does not count, like the
+	// box masks.
+	bool static ShapesOverlap(const CBoundingBox& a, const Vec2f& aPos,
+		const CBoundingBox& b, const Vec2f& bPos)
+	{
+		if (a.shape.type > b.shape.type)
+			return ShapesOverlap(b, bPos, a, aPos);
+
+		const ColliderShape& sa = a.shape;
+		const ColliderShape& sb = b.shape;
+		Vec2f delta = bPos - aPos;
+		switch (sa.type)
+		{
+		case ShapeType::Box:
+			switch (sb.type)
+			{
+			case ShapeType::Box:
+				return std::abs(delta.x) < a.halfSize.x + b.halfSize.x &&
+					std::abs(delta.y) < a.halfSize.y + b.halfSize.y;
+			case ShapeType::Circle:
+				return PointBoxDistSquared(delta, a.halfSize) < sb.radius * sb.radius;
+			case ShapeType::Capsule:
+				return SegmentBoxDistSquared(delta - CapsuleEnd(sb), delta + CapsuleEnd(sb), a.halfSize) <
+					sb.radius * sb.radius;
+			case ShapeType::OrientedBox:
+				return BoxesOverlap(delta, Vec2f(1, 0), a.halfSize, sb.axis, sb.halfExtents);
+			}
+			break;
+		case ShapeType::Circle:
+		{
+			switch (sb.type)
+			{
+			case ShapeType::Circle:
+			{
+				float reach = sa.radius + sb.radius;
+				return delta.lengthSquared() < reach * reach;
+			}
+			case ShapeType::Capsule:
+			{
+				float reach = sa.radius + sb.radius;
+				return PointSegmentDistSquared(Vec2f(0, 0), delta - CapsuleEnd(sb), delta + CapsuleEnd(sb)) <
+					reach * reach;
+			}
+			case ShapeType::OrientedBox:
+				return PointBoxDistSquared(ToLocal(delta * -1, sb.axis), sb.halfExtents) < sa.radius * sa.radius;
+			default:
+				break;
+			}
+			break;
+		}
+		case ShapeType::Capsule:
+		{
+			if (sb.type == ShapeType::Capsule)
+			{
+				float reach = sa.radius + sb.radius;
+				return SegmentSegmentDistSquared(CapsuleEnd(sa) * -1, CapsuleEnd(sa),
+					delta - CapsuleEnd(sb), delta + CapsuleEnd(sb)) < reach * reach;
+			}
+			// capsule against an oriented box, worked in the box's frame
+			Vec2f centre = delta * -1;
+			Vec2f end = CapsuleEnd(sa);
+			return SegmentBoxDistSquared(ToLocal(centre - end, sb.axis), ToLocal(centre + end, sb.axis),
+				sb.halfExtents) < sa.radius * sa.radius;
+		}
+		case ShapeType::OrientedBox:
+			return BoxesOverlap(delta, sa.axis, sa.halfExtents, sb.axis, sb.halfExtents);
+		}
+		return false;
+	}
+
+	// call fn(i) for each set bit, i counted from begin
+	template <typename F>
+	void static ForEachHit(const std::vector<uint64_t>& hits, size_t begin, F&& fn)
+	{
+		for (size_t w = 0; w < hits.size(); w++)
+		{
+			uint64_t bits = hits[w];
+			while (bits)
+			{
+				fn(begin + w * 64 + LowestBit(bits));
+				bits &= bits - 1;
+			}
+		}
+	}
 };
\ No newline at end of file
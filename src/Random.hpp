@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// PCG32 (XSH RR) generator. Every (seed, stream) pair gives an independent
+// sequence, so systems and worker threads never share state and never
+// depend on the order they draw in. Satisfies UniformRandomBitGenerator.
+class Rng
+{
+	uint64_t m_state = 0x853c49e6748fea9bULL;
+	uint64_t m_inc = 0xda3e39cb94b95bdbULL;
+
+public:
+	using result_type = uint32_t;
+
+	Rng() = default;
+	Rng(uint64_t seed, uint64_t stream)
+	{
+		m_state = 0;
+		m_inc = (stream << 1u) | 1u;
+		next();
+		m_state += seed;
+		next();
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()()
+	{
+		return next();
+	}
+
+	uint32_t next()
+	{
+		uint64_t old = m_state;
+		m_state = old * 6364136223846793005ULL + m_inc;
+		uint32_t xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+		uint32_t rot = static_cast<uint32_t>(old >> 59u);
+		return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+	}
+
+	// uniform in [0, 1)
+	float uniform()
+	{
+		return (next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// uniform in [lo, hi)
+	float uniform(float lo, float hi)
+	{
+		return lo + (hi - lo) * uniform();
+	}
+
+	// uniform integer in [0, n), without modulo bias
+	uint32_t range(uint32_t n)
+	{
+		uint64_t m = static_cast<uint64_t>(next()) * n;
+		uint32_t low = static_cast<uint32_t>(m);
+		if (low < n)
+		{
+			uint32_t threshold = (0u - n) % n;
+			while (low < threshold)
+			{
+				m = static_cast<uint64_t>(next()) * n;
+				low = static_cast<uint32_t>(m);
+			}
+		}
+		return static_cast<uint32_t>(m >> 32);
+	}
+
+	bool chance(float probability)
+	{
+		return uniform() < probability;
+	}
+};
+
+// one stream per system that draws random numbers
+enum class RngStream : uint32_t
+{
+	Level,
+	Spawn,
+	Loot,
+	Particles,
+	Audio,
+	Menu,
+	Count
+};
+
+// Engine-wide source of random streams, all derived from one session seed.
+class RandomService
+{
+	uint64_t m_seed = 0;
+	std::array<Rng, static_cast<size_t>(RngStream::Count)> m_streams;
+
+	static uint64_t mix(uint64_t x)
+	{
+		// splitmix64 finalizer
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+public:
+	RandomService() { seed(0); }
+
+	void seed(uint64_t seed)
+	{
+		m_seed = seed;
+		for (size_t i = 0; i < m_streams.size(); i++)
+		{
+			m_streams[i] = Rng(mix(seed), mix(i));
+		}
+	}
+
+	uint64_t seed() const
+	{
+		return m_seed;
+	}
+
+	Rng& stream(RngStream s)
+	{
+		return m_streams[static_cast<size_t>(s)];
+	}
+
+	// Independent generator for one piece of parallel work (a worker, a chunk
+	// of entities, ...). It is derived from the seed and key alone and does not
+	// advance any shared stream, so results do not depend on scheduling.
+	Rng split(RngStream s, uint64_t key) const
+	{
+		uint64_t system = static_cast<uint64_t>(s);
+		return Rng(mix(m_seed ^ mix(key)), mix((system << 32) ^ key) | 1u);
+	}
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Action.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Records every action delivered to a scene, tagged with the engine frame it
+// arrived on, together with the RNG seed and window size of the session.
+// Feeding the same actions back on the same frames, at the same size,
+// reproduces the run exactly.
+//
+// File layout (little endian):
+//   char[4] magic "SLRP", uint32 version, uint32 seed, uint32 width,
+//   uint32 height, uint32 endFrame
+//   uint32 eventCount, then eventCount x Event (14 bytes)
+class Replay
+{
+public:
+	struct Event
+	{
+		uint32_t frame = 0;
+		uint8_t name = 0;
+		uint8_t type = 0;
+		float mouseX = 0;
+		float mouseY = 0;
+	};
+
+private:
+	static constexpr char     Magic[4] = { 'S', 'L', 'R', 'P' };
+	static constexpr uint32_t Version = 3;
+
+	uint32_t m_seed = 0;
+	uint32_t m_width = 0;
+	uint32_t m_height = 0;
+	uint32_t m_endFrame = 0;
+	std::vector<Event> m_events;
+	size_t m_cursor = 0;
+
+	template <typename T>
+	static void write(std::ofstream& file, const T& value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	static bool read(std::ifstream& file, T& value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+public:
+	Replay() = default;
+
+	void begin(uint32_t seed, uint32_t width, uint32_t height)
+	{
+		m_seed = seed;
+		m_width = width;
+		m_height = height;
+		m_endFrame = 0;
+		m_events.clear();
+		m_cursor = 0;
+	}
+
+	void record(uint32_t frame, const Action& action)
+	{
+		Event e;
+		e.frame = frame;
+		e.name = static_cast<uint8_t>(action.m_name);
+		e.type = static_cast<uint8_t>(action.m_type);
+		e.mouseX = action.m_mousePos.x;
+		e.mouseY = action.m_mousePos.y;
+		m_events.push_back(e);
+	}
+
+	void end(uint32_t frame)
+	{
+		m_endFrame = frame;
+	}
+
+	// returns true and fills action if there is an event left for this frame
+	bool poll(uint32_t frame, Action& action)
+	{
+		if (m_cursor >= m_events.size() || m_events[m_cursor].frame != frame)
+			return false;
+
+		auto& e = m_events[m_cursor++];
+		action = Action(static_cast<ActionName>(e.name), static_cast<ActionType>(e.type),
+			Vec2f(e.mouseX, e.mouseY));
+		return true;
+	}
+
+	bool finished(uint32_t frame) const
+	{
+		return m_cursor >= m_events.size() && frame >= m_endFrame;
+	}
+
+	uint32_t seed() const
+	{
+		return m_seed;
+	}
+
+	uint32_t width() const
+	{
+		return m_width;
+	}
+
+	uint32_t height() const
+	{
+		return m_height;
+	}
+
+	uint32_t endFrame() const
+	{
+		return m_endFrame;
+	}
+
+	size_t eventCount() const
+	{
+		return m_events.size();
+	}
+
+	bool save(const std::string& path) const
+	{
+		auto file = std::ofstream(path, std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "Could not write replay file: " << path << std::endl;
+			return false;
+		}
+
+		file.write(Magic, sizeof(Magic));
+		write(file, Version);
+		write(file, m_seed);
+		write(file, m_width);
+		write(file, m_height);
+		write(file, m_endFrame);
+
+		write(file, static_cast<uint32_t>(m_events.size()));
+		for (auto& e : m_events)
+		{
+			write(file, e.frame);
+			write(file, e.name);
+			write(file, e.type);
+			write(file, e.mouseX);
+			write(file, e.mouseY);
+		}
+		return static_cast<bool>(file);
+	}
+
+	bool load(const std::string& path)
+	{
+		auto file = std::ifstream(path, std::ios::binary);
+		char magic[4] = {};
+		uint32_t version = 0;
+		if (!file.read(magic, sizeof(magic)) || !read(file, version) ||
+			std::string(magic, 4) != std::string(Magic, 4) || version != Version)
+		{
+			std::cerr << "Could not read replay file: " << path << std::endl;
+			return false;
+		}
+
+		begin(0, 0, 0);
+		read(file, m_seed);
+		read(file, m_width);
+		read(file, m_height);
+		read(file, m_endFrame);
+
+		uint32_t eventCount = 0;
+		read(file, eventCount);
+		m_events.resize(eventCount);
+		for (auto& e : m_events)
+		{
+			read(file, e.frame);
+			read(file, e.name);
+			read(file, e.type);
+			read(file, e.mouseX);
+			read(file, e.mouseY);
+		}
+
+		bool valid = static_cast<bool>(file) && m_width > 0 && m_height > 0;
+		for (auto& e : m_events)
+		{
+			valid = valid && e.name < static_cast<uint8_t>(ActionName::COUNT);
+		}
+
+		if (!valid)
+		{
+			std::cerr << "Replay file is truncated or corrupt: " << path << std::endl;
+			begin(0, 0, 0);
+			return false;
+		}
+		return true;
+	}
+};
@@ -1,6 +1,9 @@
 #include "Scene.h"
 #include "GameEngine.h"
 
+#include <algorithm>
+#include <cassert>
+
 Scene::Scene(GameEngine* gameEngine)
 	: m_game(gameEngine) { }
 
@@ -11,12 +14,22 @@ void Scene::setPaused(bool paused)
 
 size_t Scene::width() const
 {
-	return m_game->window().getSize().x;
+	return m_game->viewSize().x;
 }
 
 size_t Scene::height() const
 {
-	return m_game->window().getSize().y;
+	return m_game->viewSize().y;
+}
+
+// window().mapPixelToCoords for a view filling the window, but measured
+// against width()/height() so replayed clicks land where they were recorded
+Vec2f Scene::mapPixelToView(const Vec2f& pixel, const sf::View& view) const
+{
+	Vec2f center = view.getCenter();
+	Vec2f size = view.getSize();
+	return Vec2f(center.x + (pixel.x / width() - 0.5f) * size.x,
+		center.y + (pixel.y / height() - 0.5f) * size.y);
 }
 
 size_t Scene::currentFrame() const
@@ -29,9 +42,19 @@ const ActionMap& Scene::getActionMap() const
 	return m_actionMap;
 }
 
-void Scene::registerAction(sf::Keyboard::Scan keyCode, const std::string& name)
+ActionName Scene::getAction(sf::Keyboard::Scan keyCode) const
 {
-	m_actionMap[keyCode] = name;
+	auto index = static_cast<size_t>(keyCode);
+	if (index >= m_actionMap.size())
+		return ActionName::NONE;
+	return m_actionMap[index];
+}
+
+void Scene::registerAction(sf::Keyboard::Scan keyCode, ActionName name)
+{
+	auto index = static_cast<size_t>(keyCode);
+	assert(index < m_actionMap.size());
+	m_actionMap[index] = name;
 }
 
 bool Scene::hasEnded() const
@@ -50,14 +73,53 @@ void Scene::simulate(const size_t frames)
 
 void Scene::doAction(const Action& action)
 {
+	m_game->recordAction(action);
 	sDoAction(action);
 }
 
+// Swap live animations over to definitions that were just reloaded, keeping
+// their place in the loop and any scale or tint the scene gave the sprite.
+void Scene::reloadAnimations(const std::vector<AnimationId>& ids)
+{
+	auto& assets = m_game->assets();
+	for (auto& entity : m_entityManager.getEntities())
+	{
+		if (!entity->has<CAnimation>())
+			continue;
+		auto& animation = entity->get<CAnimation>().animation;
+		if (std::find(ids.begin(), ids.end(), animation.m_id) == ids.end())
+			continue;
+
+		size_t frame = animation.m_currentFrame;
+		auto scale = animation.m_sprite.getScale();
+		auto color = animation.m_sprite.getColor();
+		animation = assets.getAnimation(animation.m_id);
+		animation.m_currentFrame = frame;
+		animation.m_sprite.setScale(scale);
+		animation.m_sprite.setColor(color);
+	}
+}
+
 void Scene::playSound(const std::string& name, float volume)
 {
-	auto& sound = m_game->assets().getSound(name);
-	float pitch = 0.8f + static_cast<float>(rand()) / RAND_MAX * 0.4f; // range [0.8, 1.2]
-	sound.setPitch(pitch);
-	sound.setVolume(volume);
-	sound.play();
+	playSound(m_game->assets().soundId(name), volume);
+}
+
+void Scene::playSound(const std::string& name, float volume, const Vec2f& pos)
+{
+	playSound(m_game->assets().soundId(name), volume, pos);
+}
+
+void Scene::playSound(SoundId id, float volume)
+{
+	auto& assets = m_game->assets();
+	float pitch = m_game->random().stream(RngStream::Audio).uniform(0.8f, 1.2f);
+	m_game->sound().play(assets.getSoundBuffer(id), assets.getSoundSettings(id), volume, pitch);
+}
+
+void Scene::playSound(SoundId id, float volume, const Vec2f& pos)
+{
+	auto& assets = m_game->assets();
+	float pitch = m_game->random().stream(RngStream::Audio).uniform(0.8f, 1.2f);
+	m_game->sound().play(assets.getSoundBuffer(id), assets.getSoundSettings(id), volume, pitch, pos);
 }
\ No newline at end of file
@@ -1,20 +1,23 @@
 #pragma once
 
 #include "Action.hpp"
+#include "AssetId.hpp"
 #include "EntityManager.hpp"
 
+#include <array>
 #include <memory>
 
 class GameEngine;
 
-using ActionMap = std::unordered_map<sf::Keyboard::Scan, std::string>;
+// scancode -> action, ActionName::NONE where nothing is bound
+using ActionMap = std::array<ActionName, sf::Keyboard::ScancodeCount>;
 
 class Scene
 {
 protected:
 	GameEngine* m_game = nullptr;
 	EntityManager m_entityManager;
-	ActionMap m_actionMap;
+	ActionMap m_actionMap = {};
 	bool m_paused = false;
 	bool m_hasEnded = false;
 	size_t m_currentFrame = 0;
@@ -34,14 +37,21 @@ public:
 
 	virtual void doAction(const Action& action);
 	void simulate(const size_t frames);
-	void registerAction(sf::Keyboard::Scan inputKey, const std::string& actionName);
+	void registerAction(sf::Keyboard::Scan inputKey, ActionName actionName);
 
 	size_t width() const;
 	size_t height() const;
+	Vec2f mapPixelToView(const Vec2f& pixel, const sf::View& view) const;
 	size_t currentFrame() const;
 
 	bool hasEnded() const;
 	const ActionMap& getActionMap() const;
+	ActionName getAction(sf::Keyboard::Scan inputKey) const;
+
+	virtual void reloadAnimations(const std::vector<AnimationId>& ids);
 
 	void playSound(const std::string& name, float volume);
+	void playSound(const std::string& name, float volume, const Vec2f& pos);
+	void playSound(SoundId id, float volume);
+	void playSound(SoundId id, float volume, const Vec2f& pos);
 };
\ No newline at end of file
@@ -140,7 +140,7 @@ void Scene_GameOver::select()
 
 void Scene_GameOver::sDoAction(const Action& action)
 {
-	if (action.m_type == "START")
+	if (action.m_type == ActionType::START)
 	{
 		/*if (action.m_name == "PLAY")
 		{
@@ -167,16 +167,19 @@ void Scene_GameOver::sDoAction(const Action& action)
 		{
 			m_selectedMenuIndex = (m_selectedMenuIndex + 1) % m_menuStrings.size();
 		}*/
-		if (action.m_name == "QUIT")
+		switch (action.m_name)
 		{
+		case ActionName::QUIT:
 			onEnd();
-		}
-		else if (action.m_name == "MOUSE_MOVE")
+			break;
+		case ActionName::MOUSE_MOVE:
 			m_mousePos = action.m_mousePos;
-		else if (action.m_name == "LEFT_CLICK")
-		{
+			break;
+		case ActionName::LEFT_CLICK:
 			m_mousePos = action.m_mousePos;
 			select();
+			break;
+		default: break;
 		}
 	}
 }
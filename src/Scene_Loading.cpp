@@ -0,0 +1,77 @@
+#include "Scene_Loading.h"
+#include "Scene_Menu.h"
+#include "Assets.hpp"
+#include "GameEngine.h"
+#include "Action.hpp"
+
+Scene_Loading::Scene_Loading(GameEngine* gameEngine, const std::string& nextSceneName,
+	std::function<std::shared_ptr<Scene>()> makeNextScene, bool waitForAll)
+	: Scene(gameEngine)
+	, m_nextSceneName(nextSceneName)
+	, m_makeNextScene(makeNextScene)
+	, m_waitForAll(waitForAll)
+{
+}
+
+void Scene_Loading::update()
+{
+	if (m_done)
+		return;
+	auto& assets = m_game->assets();
+
+	// nothing else is running, so spend most of the frame uploading
+	assets.update(12.0f);
+
+	bool ready = m_waitForAll ? assets.loadingDone() : assets.priorityDone();
+	if (ready)
+	{
+		m_done = true;
+		if (!m_game->changeScene(m_nextSceneName, m_makeNextScene(), true))
+			m_game->changeScene("MENU", std::make_shared<Scene_Menu>(m_game), true);
+	}
+}
+
+void Scene_Loading::onEnd()
+{
+	m_game->quit();
+}
+
+void Scene_Loading::sDoAction(const Action& action)
+{
+	if (action.m_type == ActionType::START && action.m_name == ActionName::QUIT)
+	{
+		onEnd();
+	}
+}
+
+void Scene_Loading::onExitScene()
+{
+
+}
+
+void Scene_Loading::onEnterScene()
+{
+	auto& window = m_game->window();
+	window.setView(window.getDefaultView());
+}
+
+void Scene_Loading::sRender()
+{
+	auto& window = m_game->window();
+	window.clear(sf::Color(204, 226, 225));
+
+	Vec2f barSize = Vec2f(width() * 0.4f, 24.f);
+	Vec2f barPos = Vec2f(width() / 2.f, height() * 0.6f) - barSize / 2;
+
+	sf::RectangleShape back(barSize);
+	back.setPosition(barPos);
+	back.setFillColor(sf::Color(255, 255, 255, 120));
+	back.setOutlineColor(sf::Color(86, 106, 137));
+	back.setOutlineThickness(2.0f);
+	window.draw(back);
+
+	sf::RectangleShape fill(Vec2f(barSize.x * m_game->assets().loadProgress(), barSize.y));
+	fill.setPosition(barPos);
+	fill.setFillColor(sf::Color(86, 106, 137));
+	window.draw(fill);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Scene.h"
+#include <functional>
+#include <memory>
+
+#include "EntityManager.hpp"
+
+// Shows a progress bar while Assets streams in, then hands over to the next
+// scene. Draws only shapes, since fonts and textures may not be loaded yet.
+class Scene_Loading : public Scene
+{
+protected:
+	std::string m_nextSceneName;
+	std::function<std::shared_ptr<Scene>()> m_makeNextScene;
+	bool m_waitForAll = true;
+	bool m_done = false;
+
+	void update();
+	void onEnd();
+	void sDoAction(const Action& action);
+	void onExitScene();
+	void onEnterScene();
+public:
+	Scene_Loading() = default;
+	Scene_Loading(GameEngine* gameEngine, const std::string& nextSceneName,
+		std::function<std::shared_ptr<Scene>()> makeNextScene, bool waitForAll = true);
+	void sRender();
+};
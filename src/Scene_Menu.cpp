@@ -1,6 +1,7 @@
 #include "Scene_Menu.h"
 #include "Scene_Play.h"
 #include "Scene_Option.h"
+#include "Scene_Loading.h"
 #include "Assets.hpp"
 #include "GameEngine.h"
 #include "Components.hpp"
@@ -15,6 +16,11 @@ Scene_Menu::Scene_Menu(GameEngine* gameEngine)
 	init();
 }
 
+std::vector<std::string> Scene_Menu::requiredAssets()
+{
+	return { "Awakened", "Button", "ButtonHover", "FutureMillennium", "BubblierStep" };
+}
+
 void Scene_Menu::init()
 {
     m_musicName = "Awakened";
@@ -125,7 +131,15 @@ void Scene_Menu::select()
 	{
 		if (!Utils::IsInside(m_mousePos, button)) continue;
 
-		if (button->name() == "New Game" &&
+		if (button->name() == "New Game" && !m_game->assets().loadingDone())
+		{
+			// gameplay assets are still streaming in
+			auto game = m_game;
+			m_game->changeScene("LOADING", std::make_shared<Scene_Loading>(m_game, "PLAY",
+				[game] { return std::make_shared<Scene_Play>(game); }));
+			onExitScene();
+		}
+		else if (button->name() == "New Game" &&
 			m_game->changeScene("PLAY", std::make_shared<Scene_Play>(m_game)))
 			onExitScene();
 		else if (button->name() == "Continue" &&
@@ -146,7 +160,7 @@ void Scene_Menu::select()
 
 void Scene_Menu::sDoAction(const Action& action)
 {
-	if (action.m_type == "START")
+	if (action.m_type == ActionType::START)
 	{
 		/*if (action.m_name == "PLAY")
 		{
@@ -173,16 +187,19 @@ void Scene_Menu::sDoAction(const Action& action)
 		{
 			m_selectedMenuIndex = (m_selectedMenuIndex + 1) % m_menuStrings.size();
 		}*/
-		if (action.m_name == "QUIT")
+		switch (action.m_name)
 		{
+		case ActionName::QUIT:
 			onEnd();
-		}
-		else if (action.m_name == "MOUSE_MOVE")
+			break;
+		case ActionName::MOUSE_MOVE:
 			m_mousePos = action.m_mousePos;
-		else if (action.m_name == "LEFT_CLICK")
-		{
+			break;
+		case ActionName::LEFT_CLICK:
 			m_mousePos = action.m_mousePos;
 			select();
+			break;
+		default: break;
 		}
 	}
 }
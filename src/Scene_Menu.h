@@ -28,4 +28,7 @@ public:
 	Scene_Menu() = default;
 	Scene_Menu(GameEngine* gameEngine = nullptr);
 	void sRender();
+
+	// loaded before everything else so the menu comes up early
+	static std::vector<std::string> requiredAssets();
 };
\ No newline at end of file
@@ -7,7 +7,6 @@
 #include "Utils.hpp"
 
 #include <iostream>
-#include <random>
 #include <algorithm>
 
 Scene_NewWeapon::Scene_NewWeapon(GameEngine* gameEngine, std::shared_ptr<Entity> player)
@@ -64,9 +63,8 @@ void Scene_NewWeapon::init(std::shared_ptr<Entity> player)
 	if (!player->has<CBulletAttack>())
 		playerWeapons.push_back("LaserBullet");
 
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::shuffle(playerWeapons.begin(), playerWeapons.end(), gen);
+	std::shuffle(playerWeapons.begin(), playerWeapons.end(),
+		m_game->random().stream(RngStream::Menu));
 
 	size_t count = std::min<size_t>(3, playerWeapons.size());
 	std::vector<std::string> weapons(playerWeapons.begin(), playerWeapons.begin() + count);
@@ -176,7 +174,7 @@ void Scene_NewWeapon::select()
 
 void Scene_NewWeapon::sDoAction(const Action& action)
 {
-	if (action.m_type == "START")
+	if (action.m_type == ActionType::START)
 	{
 		/*if (action.m_name == "PLAY")
 		{
@@ -203,16 +201,19 @@ void Scene_NewWeapon::sDoAction(const Action& action)
 		{
 			m_selectedMenuIndex = (m_selectedMenuIndex + 1) % m_menuStrings.size();
 		}*/
-		if (action.m_name == "QUIT")
+		switch (action.m_name)
 		{
+		case ActionName::QUIT:
 			onEnd();
-		}
-		else if (action.m_name == "MOUSE_MOVE")
+			break;
+		case ActionName::MOUSE_MOVE:
 			m_mousePos = action.m_mousePos;
-		else if (action.m_name == "LEFT_CLICK")
-		{
+			break;
+		case ActionName::LEFT_CLICK:
 			m_mousePos = action.m_mousePos;
 			select();
+			break;
+		default: break;
 		}
 	}
 }
@@ -15,6 +15,10 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <iomanip>
 #include <cmath>
 #include <math.h>
 
@@ -27,38 +31,50 @@ Scene_Play::Scene_Play(GameEngine* gameEngine, const std::string& levelPath)
 
 void Scene_Play::init(const std::string& levelPath)
 {
-	registerAction(sf::Keyboard::Scan::P, "NEW_WEAPON");
-	registerAction(sf::Keyboard::Scan::O, "LEVEL_WEAPON");
-	registerAction(sf::Keyboard::Scan::Escape, "ESCAPE");
-	registerAction(sf::Keyboard::Scan::H, "DISPLAY_HITBOX");
-
-	registerAction(sf::Keyboard::Scan::A, "LEFT");
-	registerAction(sf::Keyboard::Scan::D, "RIGHT");
-	registerAction(sf::Keyboard::Scan::W, "UP");
-	registerAction(sf::Keyboard::Scan::S, "DOWN");
-	registerAction(sf::Keyboard::Scan::Left, "LEFT");
-	registerAction(sf::Keyboard::Scan::Right, "RIGHT");
-	registerAction(sf::Keyboard::Scan::Up, "UP");
-	registerAction(sf::Keyboard::Scan::Down, "DOWN");
-
-	registerAction(sf::Keyboard::Scan::Z, "TOGGLE_AUTO_AIM");
-	registerAction(sf::Keyboard::Scan::X, "TOGGLE_AUTO_ATTACK");
-	registerAction(sf::Keyboard::Scan::Q, "RING_ATTACK");
-	registerAction(sf::Keyboard::Scan::R, "EXPLODE_ATTACK");
-	registerAction(sf::Keyboard::Scan::E, "WHIRL_ATTACK");
-	registerAction(sf::Keyboard::Scan::F, "BULLET_ATTACK");
+	registerAction(sf::Keyboard::Scan::P, ActionName::NEW_WEAPON);
+	registerAction(sf::Keyboard::Scan::O, ActionName::LEVEL_WEAPON);
+	registerAction(sf::Keyboard::Scan::Escape, ActionName::ESCAPE);
+	registerAction(sf::Keyboard::Scan::H, ActionName::DISPLAY_HITBOX);
+
+	registerAction(sf::Keyboard::Scan::A, ActionName::LEFT);
+	registerAction(sf::Keyboard::Scan::D, ActionName::RIGHT);
+	registerAction(sf::Keyboard::Scan::W, ActionName::UP);
+	registerAction(sf::Keyboard::Scan::S, ActionName::DOWN);
+	registerAction(sf::Keyboard::Scan::Left, ActionName::LEFT);
+	registerAction(sf::Keyboard::Scan::Right, ActionName::RIGHT);
+	registerAction(sf::Keyboard::Scan::Up, ActionName::UP);
+	registerAction(sf::Keyboard::Scan::Down, ActionName::DOWN);
+
+	registerAction(sf::Keyboard::Scan::Z, ActionName::TOGGLE_AUTO_AIM);
+	registerAction(sf::Keyboard::Scan::X, ActionName::TOGGLE_AUTO_ATTACK);
+	registerAction(sf::Keyboard::Scan::Q, ActionName::RING_ATTACK);
+	registerAction(sf::Keyboard::Scan::R, ActionName::EXPLODE_ATTACK);
+	registerAction(sf::Keyboard::Scan::E, ActionName::WHIRL_ATTACK);
+	registerAction(sf::Keyboard::Scan::F, ActionName::BULLET_ATTACK);
+
+	resolveAssets();
+	if (!loadEnemyTypes("assets/enemies.txt"))
+	{
+		std::cerr << "No usable enemies in assets/enemies.txt, cannot start the level" << std::endl;
+		m_hasEnded = true;
+		return;
+	}
 
+	m_collisionMatrix.enable(CollisionLayer::Enemy, CollisionLayer::Player);
+	m_collisionMatrix.enable(CollisionLayer::Enemy, CollisionLayer::PlayerAttack);
+	m_collisionMatrix.enable(CollisionLayer::Enemy, CollisionLayer::Enemy);
+	m_collisionMatrix.enable(CollisionLayer::Pickup, CollisionLayer::Player);
 	m_playerConfig = { 0, 0, 0, 0, 2.0f, 0, ""};
 
-	m_particleSystem.init(m_game->window().getSize());
+	m_particleSystem.init(m_game->window().getSize(),
+		m_game->random().split(RngStream::Particles, 0));
 	m_cameraView.setSize(sf::Vector2f(width(), height()));
 	m_cameraView.zoom(0.5f);
 	m_game->window().setView(m_cameraView);
 
-	srand(static_cast<unsigned int>(time(nullptr)));
 	std::vector<std::string> bgms = { "Awakened", "CargoHold", "TempleoftheValley",
 		"Gaia'sGarden", "TempleoftheLake"};
-	int randomIndex = rand() % bgms.size();
+	int randomIndex = m_game->random().stream(RngStream::Level).range(bgms.size());
 
 	m_musicName = bgms[randomIndex];
 	auto& bgm = m_game->assets().getMusic(m_musicName);
@@ -81,33 +97,77 @@ Vec2f Scene_Play::gridToMidPixel(float gridX, float gridY, std::shared_ptr<Entit
 	);
 }
 
-std::shared_ptr<Entity> Scene_Play::getNearestEnemy(std::shared_ptr<Entity> entity)
+std::shared_ptr<Entity> Scene_Play::getNearestEnemy(std::shared_ptr<Entity> entity, float maxDist)
 {
-	float minDist = 1000;
-	std::shared_ptr<Entity> nearestEnemy = nullptr;
+	auto& enemies = m_entityManager.getEntities("enemy");
+	int nearest = m_enemyGrid.nearest(entity->get<CTransform>().pos, maxDist,
+		[&](size_t i) { return enemies[i]->id() != entity->id(); });
 
-	auto& eTransform = entity->get<CTransform>();
-	for (auto& enemy : m_entityManager.getEntities("enemy"))
-	{
-		if (enemy->id() == entity->id())
-			continue;
+	if (nearest < 0)
+		return nullptr;
+	return enemies[nearest];
+}
 
-		auto& enemyTransform = enemy->get<CTransform>();
-		float dist = (enemyTransform.pos - eTransform.pos).length();
-		if (dist < minDist)
-		{
-			minDist = dist;
-			nearestEnemy = enemy;
-		}
-	}
-	return nearestEnemy;
+void Scene_Play::resolveAssets()
+{
+	auto& assets = m_game->assets();
+	m_assetIds.stormheadIdle = assets.animationId("StormheadIdle");
+	m_assetIds.stormheadRun = assets.animationId("StormheadRun");
+	m_assetIds.stormheadDeath = assets.animationId("StormheadDeath");
+	m_assetIds.gem = assets.animationId("Gem");
+	m_assetIds.heart = assets.animationId("Heart");
+	m_assetIds.slash1 = assets.animationId("Slash1");
+	m_assetIds.bullet1 = assets.animationId("Bullet1");
+	m_assetIds.ring1 = assets.animationId("Ring1");
+	m_assetIds.explode1 = assets.animationId("Explode1");
+	m_assetIds.ring2 = assets.animationId("Ring2");
+	m_assetIds.futureMillennium = assets.fontId("FutureMillennium");
+	m_assetIds.plasticZap = assets.soundId("PlasticZap");
+	m_assetIds.coinZap = assets.soundId("CoinZap");
+	m_assetIds.laserPebble = assets.soundId("LaserPebble");
+	m_assetIds.swordSlash = assets.soundId("SwordSlash");
+	m_assetIds.highWhoosh = assets.soundId("HighWhoosh");
+	m_assetIds.laserShot = assets.soundId("LaserShot");
+	m_assetIds.fireSphere = assets.soundId("FireSphere");
+	m_assetIds.fireHit = assets.soundId("FireHit");
+	m_assetIds.bubbleStep = assets.soundId("BubbleStep");
+
+	auto& ids = m_assetIds;
+	assets.prefetchSounds({ ids.plasticZap, ids.coinZap, ids.laserPebble, ids.swordSlash,
+		ids.highWhoosh, ids.laserShot, ids.fireSphere, ids.fireHit, ids.bubbleStep }, m_game->threadPool());
 }
 
 void Scene_Play::loadLevel(const std::string& filename = "")
 {
 	m_entityManager = EntityManager();
+	m_timers.clear(m_currentFrame);
+	m_itemGrid.clear();
+	m_itemSlots.clear();
+	m_awakeItems.clear();
+	m_damageEvents.clear();
+	m_damagePopups.clear();
 	spawnPlayer();
 	m_entityManager.update();
+
+	if (filename.empty())
+		return;
+	auto file = std::ifstream(filename);
+	if (!file)
+	{
+		std::cerr << "Could not open level file: " << filename << std::endl;
+		return;
+	}
+
+	// settings lines; Tile lines are not read yet
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream ss(line);
+		std::string key;
+		ss >> key;
+		if (key == "MaxGems" && !(ss >> m_maxGems))
+			std::cerr << "Bad MaxGems line in " << filename << ": " << line << std::endl;
+	}
 }
 
 std::shared_ptr<Entity> Scene_Play::player()
@@ -122,8 +182,9 @@ void Scene_Play::spawnPlayer()
 	auto p = m_entityManager.addEntity("player", "playerCharacter");
 	m_playerDied = false;
 	
-	auto& pAnimation = p->add<CAnimation>(m_game->assets().getAnimation("StormheadIdle"), true);
-	p->add<CBoundingBox>(Vec2f(pAnimation.animation.m_size.x / 4, pAnimation.animation.m_size.y / 4));
+	auto& pAnimation = p->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.stormheadIdle), true);
+	p->add<CBoundingBox>(Vec2f(pAnimation.animation.m_size.x / 4, pAnimation.animation.m_size.y / 4),
+		CollisionLayer::Player);
 	auto& pTransform = p->add<CTransform>(gridToMidPixel(m_playerConfig.X, m_playerConfig.Y, p));
 	pTransform.speed = m_playerConfig.SPEED;
 	p->add<CHealth>(100);
@@ -134,154 +195,173 @@ void Scene_Play::spawnPlayer()
 	p->add<CKnockback>(10.f, 30);
 	p->add<CAttractor>(50.0f, 150.0f);
 
-	p->add<CBasicAttack>(m_currentFrame);
-}
-
-void Scene_Play::sSpawnEnemies()
-{
-	if (m_entityManager.getEntities("enemy").size() > 500)
-		return;
-
-	spawnChainBot();
-	spawnBigChainBot();
-	spawnBotWheel();
-	spawnBigBotWheel();
+	auto& pBasicAttack = p->add<CBasicAttack>(m_currentFrame);
+	pBasicAttack.ready = false;
+	startCooldown(Weapon::Basic, pBasicAttack.cooldown);
 }
 
-void Scene_Play::spawnChainBot()
+// false if no archetype survived, which leaves nothing to spawn
+bool Scene_Play::loadEnemyTypes(const std::string& path)
 {
-	auto& pLevel = player()->get<CScore>().level;
-	static int lastEnemySpawnTime = 0;
-	int enemySpawnInterval = 180 * std::pow(0.90f, pLevel);
-	if (m_currentFrame - lastEnemySpawnTime > enemySpawnInterval)
+	auto& assets = m_game->assets();
+	m_enemyTypes.clear();
+	for (auto& archetype : parseEnemyArchetypes(path))
 	{
-		lastEnemySpawnTime = m_currentFrame;
-
-		for (int i = 0; i < 3 + pLevel; i++)
+		EnemyType type;
+		type.archetype = archetype;
+		type.idle = assets.findAnimationId(archetype.idle);
+		type.hit = assets.findAnimationId(archetype.hit);
+		type.death = assets.findAnimationId(archetype.death);
+		if (!type.idle.valid() || !type.hit.valid() || !type.death.valid())
 		{
-			int spawnAngle = rand() % 360;
-			Vec2f spawnPoint = Vec2f(std::cos(spawnAngle), std::sin(spawnAngle)) * height() / 2;
-
-			auto enemy = m_entityManager.addEntity("enemy", "chainBot");
-			auto& eAnimation = enemy->add<CAnimation>(m_game->assets().getAnimation("ChainBotIdle"), true);
-			enemy->add<CTransform>(player()->get<CTransform>().pos + spawnPoint);
-			enemy->add<CBoundingBox>(eAnimation.animation.m_size / 2);
-			enemy->add<CHealth>(30 + pLevel * 10);
-			enemy->add<CDamage>(10);
-			enemy->add<CFollow>(player(), 0.2f);
-			enemy->add<CScore>(1);
-			enemy->add<CState>("alive");
+			std::cerr << "Unknown animation for enemy " << archetype.name << " ("
+				<< archetype.idle << " " << archetype.hit << " " << archetype.death
+				<< "), skipping it" << std::endl;
+			continue;
 		}
+		m_enemyTypes.push_back(type);
 	}
+	bakeEnemyTypes();
+	return !m_enemyTypes.empty();
 }
 
-void Scene_Play::spawnBotWheel()
+// Everything an enemy starts with, apart from what depends on where and when
+// it spawns and the player's level.
+void Scene_Play::bakeEnemyTypes()
 {
-	auto& pLevel = player()->get<CScore>().level;
-	static int lastEnemySpawnTime = 0;
-	int enemySpawnInterval = 240 * std::pow(0.90f, pLevel);;
-	if (m_currentFrame - lastEnemySpawnTime > enemySpawnInterval)
+	auto& assets = m_game->assets();
+	for (size_t i = 0; i < m_enemyTypes.size(); i++)
 	{
-		lastEnemySpawnTime = m_currentFrame;
-
-		for (int i = 0; i < 4 + pLevel; i++)
-		{
-			int spawnAngle = rand() % 360;
-			Vec2f spawnPoint = Vec2f(std::cos(spawnAngle), std::sin(spawnAngle)) * height() / 2;
-
-			auto enemy = m_entityManager.addEntity("enemy", "botWheel");
-			auto& eAnimation = enemy->add<CAnimation>(m_game->assets().getAnimation("BotWheelRun"), true);
-			enemy->add<CTransform>(player()->get<CTransform>().pos + spawnPoint);
-			enemy->add<CBoundingBox>(eAnimation.animation.m_size / 2);
-			enemy->add<CHealth>(40 + pLevel * 12);
-			enemy->add<CDamage>(10);
-			enemy->add<CFollow>(player(), 0.3f);
-			enemy->add<CScore>(2);
-			enemy->add<CState>("alive");
-		}
+		auto& type = m_enemyTypes[i];
+		auto& archetype = type.archetype;
+		auto& blueprint = type.blueprint;
+		blueprint = EntityBlueprint();
+
+		blueprint.add<CTransform>().scale = archetype.scale;
+		auto& animation = blueprint.add<CAnimation>(assets.getAnimation(type.idle), true).animation;
+		animation.m_sprite.setScale(Vec2f(archetype.scale, archetype.scale));
+		blueprint.add<CBoundingBox>(animation.m_size / 2 * archetype.scale, CollisionLayer::Enemy);
+		blueprint.add<CDamage>(archetype.damage);
+		blueprint.add<CFollow>(nullptr, archetype.speed);
+		blueprint.add<CState>("alive");
+		blueprint.add<CArchetype>(i);
 	}
 }
 
-void Scene_Play::spawnBigChainBot()
+void Scene_Play::reloadAnimations(const std::vector<AnimationId>& ids)
 {
-	auto& pLevel = player()->get<CScore>().level;
-	static int lastEnemySpawnTime = 0;
-	int enemySpawnInterval = 750 * std::pow(0.90f, pLevel);
-	if (m_currentFrame - lastEnemySpawnTime > enemySpawnInterval)
-	{
-		lastEnemySpawnTime = m_currentFrame;
-
-		int spawnAngle = rand() % 360;
-		Vec2f spawnPoint = Vec2f(std::cos(spawnAngle), std::sin(spawnAngle)) * height() / 2;
+	Scene::reloadAnimations(ids);
+	bakeEnemyTypes();
+}
 
-		auto enemy = m_entityManager.addEntity("enemy", "chainBot");
-		auto& eTransform = enemy->add<CTransform>(player()->get<CTransform>().pos + spawnPoint);
-		eTransform.scale = 2.0f;
+void Scene_Play::sSpawnEnemies()
+{
+	if (m_entityManager.getEntities("enemy").size() > 500)
+		return;
 
-		auto& eAnimation = enemy->add<CAnimation>(m_game->assets().getAnimation("ChainBotIdle"), true);
-		eAnimation.animation.m_sprite.setScale(Vec2f(eTransform.scale, eTransform.scale));
-		
-		enemy->add<CBoundingBox>(eAnimation.animation.m_size / 2 * eTransform.scale);
-		enemy->add<CHealth>(200 + pLevel * 100);
-		enemy->add<CDamage>(20);
-		enemy->add<CFollow>(player(), 0.1f);
-		enemy->add<CScore>(6 + pLevel * 2);
-		enemy->add<CState>("alive");
+	int level = player()->get<CScore>().level;
+	for (auto& type : m_enemyTypes)
+	{
+		if (m_currentFrame - type.lastSpawn <= static_cast<size_t>(type.archetype.intervalAt(level)))
+			continue;
+		type.lastSpawn = m_currentFrame;
+		spawnEnemyWave(type, level);
 	}
 }
 
-void Scene_Play::spawnBigBotWheel()
+void Scene_Play::spawnEnemyWave(const EnemyType& type, int level)
 {
-	auto& pLevel = player()->get<CScore>().level;
-	static int lastEnemySpawnTime = 0;
-	int enemySpawnInterval = 900 * std::pow(0.90f, pLevel);
-	if (m_currentFrame - lastEnemySpawnTime > enemySpawnInterval)
+	auto& archetype = type.archetype;
+	auto& spawnRng = m_game->random().stream(RngStream::Spawn);
+	auto target = player();
+	Vec2f center = target->get<CTransform>().pos;
+	int health = archetype.healthAt(level);
+	int score = archetype.scoreAt(level);
+
+	auto wave = m_entityManager.addEntities("enemy", archetype.name,
+		static_cast<size_t>(std::max(archetype.countAt(level), 0)), type.blueprint);
+	for (auto& enemy : wave)
 	{
-		lastEnemySpawnTime = m_currentFrame;
-
-		int spawnAngle = rand() % 360;
+		float spawnAngle = spawnRng.uniform(0.f, 2.f * 3.14159f);
 		Vec2f spawnPoint = Vec2f(std::cos(spawnAngle), std::sin(spawnAngle)) * height() / 2;
 
-		auto enemy = m_entityManager.addEntity("enemy", "botWheel");
-		auto& eTransform = enemy->add<CTransform>(player()->get<CTransform>().pos + spawnPoint);
-		eTransform.scale = 2.0f;
-
-		auto& eAnimation = enemy->add<CAnimation>(m_game->assets().getAnimation("BotWheelRun"), true);
-		eAnimation.animation.m_sprite.setScale(Vec2f(eTransform.scale, eTransform.scale));
-
-		enemy->add<CBoundingBox>(eAnimation.animation.m_size / 2 * eTransform.scale);
-		enemy->add<CHealth>(250 + pLevel * 120);
-		enemy->add<CDamage>(20);
-		enemy->add<CFollow>(player(), 0.2f);
-		enemy->add<CScore>(8 + pLevel * 2);
-		enemy->add<CState>("alive");
+		enemy->get<CTransform>().pos = center + spawnPoint;
+		enemy->get<CFollow>().target = target;
+		enemy->add<CHealth>(health);
+		enemy->add<CScore>(score);
+		enemy->add<CSimLod>(enemy->id() % 4, m_currentFrame);
 	}
 }
 
 void Scene_Play::spawnGem(const Vec2f& pos)
 {
-	int spawnAngle = rand() % 360;
+	float spawnAngle = m_game->random().stream(RngStream::Loot).uniform(0.f, 2.f * 3.14159f);
 	Vec2f spawnPoint = Vec2f(std::cos(spawnAngle), std::sin(spawnAngle)) * 10;
 
 	auto gem = m_entityManager.addEntity("gem", "scoreGem");
 
 	gem->add<CTransform>(pos + spawnPoint);
-	auto& gemAnimation = gem->add<CAnimation>(m_game->assets().getAnimation("Gem"), true);
-	gem->add<CBoundingBox>(gemAnimation.animation.m_size);
+	auto& gemAnimation = gem->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.gem), true);
+	gem->add<CBoundingBox>(gemAnimation.animation.m_size, CollisionLayer::Pickup);
 	gem->add<CScore>(1);
+	addItem(gem);
+}
+
+void Scene_Play::mergeGem(std::shared_ptr<Entity> into, std::shared_ptr<Entity> from)
+{
+	auto& iTransform = into->get<CTransform>();
+	auto& iScore = into->get<CScore>().score;
+	int fScore = from->get<CScore>().score;
+
+	// score-weighted centre keeps big clusters where most of the value was
+	iTransform.pos = (iTransform.pos * static_cast<float>(iScore) + from->get<CTransform>().pos * static_cast<float>(fScore))
+		/ static_cast<float>(iScore + fScore);
+	iScore += fScore;
+	removeItem(from);
+
+	iTransform.scale = std::min(1.0f + 0.25f * std::log2(static_cast<float>(iScore)), 2.5f);
+	auto& animation = into->get<CAnimation>().animation;
+	animation.m_sprite.setScale(Vec2f(iTransform.scale, iTransform.scale));
+	auto& box = into->get<CBoundingBox>();
+	box = CBoundingBox(animation.m_size * iTransform.scale, CollisionLayer::Pickup);
+	auto& halfSize = box.halfSize;
+	m_itemMaxHalfSize = std::max({ m_itemMaxHalfSize, halfSize.x, halfSize.y });
+
+	m_itemGrid.move(into->get<CItem>().gridHandle, iTransform.pos);
 }
 
 void Scene_Play::spawnHeart(const Vec2f& pos)
 {
-	int spawnAngle = rand() % 360;
+	float spawnAngle = m_game->random().stream(RngStream::Loot).uniform(0.f, 2.f * 3.14159f);
 	Vec2f spawnPoint = Vec2f(std::cos(spawnAngle), std::sin(spawnAngle)) * 10;
 
 	auto heart = m_entityManager.addEntity("heart", "Heart");
 
 	heart->add<CTransform>(pos + spawnPoint);
-	auto& gemAnimation = heart->add<CAnimation>(m_game->assets().getAnimation("Heart"), true);
-	heart->add<CBoundingBox>(gemAnimation.animation.m_size);
+	auto& gemAnimation = heart->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.heart), true);
+	heart->add<CBoundingBox>(gemAnimation.animation.m_size, CollisionLayer::Pickup);
 	heart->add<CHealth>(5);
+	addItem(heart);
+}
+
+void Scene_Play::addItem(std::shared_ptr<Entity> item)
+{
+	size_t handle = m_itemGrid.insert(item->get<CTransform>().pos);
+	if (handle >= m_itemSlots.size())
+		m_itemSlots.resize(handle + 1);
+	m_itemSlots[handle] = item;
+	item->add<CItem>(handle);
+
+	auto& halfSize = item->get<CBoundingBox>().halfSize;
+	m_itemMaxHalfSize = std::max({ m_itemMaxHalfSize, halfSize.x, halfSize.y });
+}
+
+void Scene_Play::removeItem(std::shared_ptr<Entity> item)
+{
+	size_t handle = item->get<CItem>().gridHandle;
+	m_itemGrid.remove(handle);
+	m_itemSlots[handle] = nullptr;
+	item->destroy();
 }
 
 void Scene_Play::spawnTiles(const std::string& filename)
@@ -294,15 +374,18 @@ void Scene_Play::update()
 	if (!m_paused)
 	{
 		m_entityManager.update();
-		sLifespan();
+		sTimers();
 		sDisappearingText();
 		sSpawnEnemies();
+		sSpatialIndex();
+		sSimulationLod();
 		sPlayerAttacks();
 		sAI();
-		sKnockback();
 		sAttraction();
 		sMovement();
 		sCollision();
+		sDamage();
+		sCoalesceGems();
 		sScore();
 		sSound();
 		sCamera();
@@ -373,9 +456,25 @@ void Scene_Play::sMovement()
 		player()->get<CState>().state = "idle";
 
 
+	m_moveEntities.clear();
+	m_movePos.clear();
+	m_moveVel.clear();
+	m_moveAccel.clear();
+	m_moveSteps.clear();
 	for (auto& entity : m_entityManager.getEntities())
 	{
 		auto& eTransform = entity->get<CTransform>();
+		eTransform.prevPos = eTransform.pos;
+
+		float steps = 1;
+		if (entity->has<CSimLod>())
+		{
+			auto& lod = entity->get<CSimLod>();
+			if (!lod.due(m_currentFrame))
+				continue;
+			steps = lod.steps(m_currentFrame);
+			lod.lastStep = m_currentFrame;
+		}
 
 		if (entity->has<CMoveAtSameVelocity>())
 		{
@@ -383,30 +482,164 @@ void Scene_Play::sMovement()
 			auto& tTransform = target->get<CTransform>();
 			eTransform.velocity = tTransform.velocity;
 		}
-		eTransform.prevPos = eTransform.pos;
-		
-		float newSpeed = eTransform.velocity.length() + eTransform.accel;
-		eTransform.velocity = eTransform.velocity.normalize() * newSpeed;
 
-		eTransform.pos += eTransform.velocity;
+		m_moveEntities.push_back(entity.get());
+		m_movePos.push_back(eTransform.pos);
+		m_moveVel.push_back(eTransform.velocity);
+		m_moveAccel.push_back(eTransform.accel);
+		m_moveSteps.push_back(steps);
+	}
+
+	Vec2Batch::integrate(m_movePos, m_moveVel, m_moveAccel, m_moveSteps);
+
+	for (size_t i = 0; i < m_moveEntities.size(); i++)
+	{
+		auto& eTransform = m_moveEntities[i]->get<CTransform>();
+		eTransform.pos = m_movePos[i];
+		eTransform.velocity = m_moveVel[i];
+	}
+}
+
+void Scene_Play::gatherEnemyPositions()
+{
+	m_enemyPositions.clear();
+	m_enemyMaxHalfSize = 0;
+	for (auto& enemy : m_entityManager.getEntities("enemy"))
+	{
+		m_enemyPositions.push_back(enemy->get<CTransform>().pos);
+		if (enemy->has<CBoundingBox>())
+		{
+			auto& halfSize = enemy->get<CBoundingBox>().halfSize;
+			m_enemyMaxHalfSize = std::max({ m_enemyMaxHalfSize, halfSize.x, halfSize.y });
+		}
+	}
+}
+
+void Scene_Play::sSpatialIndex()
+{
+	gatherEnemyPositions();
+	m_enemyGrid.build(m_enemyPositions);
+}
+
+// Enemies well outside the view step less often. The near band reaches past
+// the screen edge, so anything about to come into view is back at full detail.
+void Scene_Play::sSimulationLod()
+{
+	Vec2f center = m_cameraView.getCenter();
+	Vec2f half = Vec2f(m_cameraView.getSize()) / 2.f;
+	for (auto& enemy : m_entityManager.getEntities("enemy"))
+	{
+		if (!enemy->has<CSimLod>())
+			continue;
+
+		auto& lod = enemy->get<CSimLod>();
+		Vec2f offset = enemy->get<CTransform>().pos - center;
+		float distance = std::max(std::abs(offset.x) / half.x, std::abs(offset.y) / half.y);
+		// Knockback and death run on timers and animations that need every
+		// tick. The skipped ticks are dropped rather than caught up, or the
+		// first step would carry the knockback velocity several ticks' worth.
+		if (enemy->get<CState>().state != "alive")
+		{
+			if (lod.stride > 1 && m_currentFrame > 0)
+				lod.lastStep = m_currentFrame - 1;
+			lod.stride = 1;
+		}
+		else if (distance < m_lodNear)
+			lod.stride = 1;
+		else if (distance < m_lodFar)
+			lod.stride = 2;
+		else
+			lod.stride = 4;
 	}
 }
 
 void Scene_Play::sAI()
 {
+	m_flowField.build(player()->get<CTransform>().pos, m_enemyPositions);
+	sf::Clock aiClock;
+
+	m_steerEntities.clear();
+	m_steerVel.clear();
+	m_steerDesired.clear();
+	m_steerScale.clear();
+	m_steerRefresh.clear();
+	m_steerDir.clear();
+	m_steerSpeed.clear();
 	for (auto& entity : m_entityManager.getEntities())
 	{
 		if (!entity->has<CFollow>())
 			continue;
 
+		// a reduced-detail step steers as far as the ticks it covers
+		float steering = entity->get<CFollow>().steering_scale;
+		bool reduced = false;
+		if (entity->has<CSimLod>())
+		{
+			auto& lod = entity->get<CSimLod>();
+			if (!lod.due(m_currentFrame))
+				continue;
+			steering = std::min(steering * lod.steps(m_currentFrame), 1.0f);
+			reduced = lod.stride > 1;
+		}
+
 		auto& eFollow = entity->get<CFollow>();
-		auto& tTransform = eFollow.target->get<CTransform>();
 		auto& eTransform = entity->get<CTransform>();
 
-		Vec2f desired = (tTransform.pos - eTransform.pos).normalize() * eFollow.speed;
-		Vec2f steering = (desired - eTransform.velocity) * eFollow.steering_scale;
-		eTransform.velocity += steering;
+		// Round robin: a follower re-aims once every m_aiSlices ticks and
+		// coasts toward its cached desired velocity in between. Reduced-detail
+		// steps are already spread out, so they always re-aim.
+		if (!eFollow.aimed || reduced || (entity->id() + m_currentFrame) % m_aiSlices == 0)
+		{
+			auto& tTransform = eFollow.target->get<CTransform>();
+			m_steerRefresh.push_back(m_steerEntities.size());
+			m_steerDir.push_back(eFollow.target == player()
+				? m_flowField.direction(eTransform.pos)
+				: tTransform.pos - eTransform.pos);
+			m_steerSpeed.push_back(eFollow.speed);
+		}
+		m_steerEntities.push_back(entity.get());
+		m_steerVel.push_back(eTransform.velocity);
+		m_steerDesired.push_back(eFollow.desired);
+		m_steerScale.push_back(steering);
+	}
+
+	Vec2Batch::normalize(m_steerDir);
+	Vec2Batch::scale(m_steerDir, m_steerSpeed);
+	for (size_t r = 0; r < m_steerRefresh.size(); r++)
+	{
+		size_t i = m_steerRefresh[r];
+		auto& eFollow = m_steerEntities[i]->get<CFollow>();
+		eFollow.desired = m_steerDir[r];
+		eFollow.aimed = true;
+		m_steerDesired.x[i] = eFollow.desired.x;
+		m_steerDesired.y[i] = eFollow.desired.y;
+	}
+
+	Vec2Batch::approach(m_steerVel, m_steerDesired, m_steerScale);
+
+	for (size_t i = 0; i < m_steerEntities.size(); i++)
+	{
+		m_steerEntities[i]->get<CTransform>().velocity = m_steerVel[i];
 	}
+
+	adaptAiSlices(aiClock.getElapsedTime().asMicroseconds() / 1000.0f);
+}
+
+// Widen the round robin while sAI runs over its budget and narrow it again
+// once it is well under. Replays must steer the same way on every run, so
+// the slice count holds still while recording or playing one back.
+void Scene_Play::adaptAiSlices(float aiMs)
+{
+	if (m_game->deterministic())
+		return;
+
+	m_aiMs = m_aiMs * 0.9f + aiMs * 0.1f;
+	if (m_currentFrame % 30 != 0)
+		return;
+	if (m_aiMs > m_aiBudgetMs && m_aiSlices < m_aiMaxSlices)
+		m_aiSlices *= 2;
+	else if (m_aiMs < m_aiBudgetMs / 4 && m_aiSlices > 1)
+		m_aiSlices /= 2;
 }
 
 void Scene_Play::sStatus()
@@ -421,8 +654,10 @@ void Scene_Play::applyKnockback(std::shared_ptr<Entity> target, const Vec2f& fro
 	Vec2f direction = (tTransform.pos - fromPos).normalize();
 	auto& tKnockback = target->add<CKnockback>(force, duration);
 	tKnockback.beingKnockedback = true;
+	tKnockback.endFrame = m_currentFrame + duration + 1;
+	scheduleEvent(duration + 1, TimedEventType::KnockbackEnd, target);
 
-	if (target->tag() == "enemy")
+	if (target->tag() == "enemy" && target->get<CState>().state != "dead")
 	{
 		target->get<CState>().state = "knockback";
 	}
@@ -431,161 +666,491 @@ void Scene_Play::applyKnockback(std::shared_ptr<Entity> target, const Vec2f& fro
 	tTransform.accel = -0.2f * tTransform.scale;
 }
 
-void Scene_Play::sKnockback() {
-	for (auto& e : m_entityManager.getEntities("enemy")) {
-		if (!e->has<CKnockback>()) continue;
+void Scene_Play::endKnockback(std::shared_ptr<Entity> target)
+{
+	auto& kb = target->get<CKnockback>();
+	// a later knockback replaced this one and scheduled its own end
+	if (!kb.beingKnockedback || kb.endFrame > static_cast<int>(m_currentFrame))
+		return;
 
-		auto& kb = e->get<CKnockback>();
-		if (!kb.beingKnockedback) continue;
+	auto& transform = target->get<CTransform>();
+	transform.velocity = { 0, 0 };
+	transform.accel = 0;
+	target->remove<CKnockback>();
 
-		if (kb.duration > 0)
-		{
-			kb.duration--;
-		}
-		else
-		{
-			auto& transform = e->get<CTransform>();
-			transform.velocity = { 0, 0 };
-			transform.accel = 0;
-			e->remove<CKnockback>();
-
-			if (e->get<CHealth>().health <= 0)
-				e->get<CState>().state = "dead";
-			else
-				e->get<CState>().state = "alive";		
-		}
-	}
+	if (target->get<CHealth>().health <= 0)
+		target->get<CState>().state = "dead";
+	else
+		target->get<CState>().state = "alive";
 }
 
 bool Scene_Play::applyDamage(std::shared_ptr<Entity> e1, std::shared_ptr<Entity> e2)
 {
 	auto& e1Health = e1->get<CHealth>();
 	auto& e2Health = e2->get<CHealth>();
-	if (m_currentFrame - e1Health.lastTakenDamage < e1Health.invulTime)
+	if (e1Health.invulnerable)
 	{
 		return false;
 	}
 	e1Health.lastTakenDamage = m_currentFrame;
+	e1Health.invulnerable = true;
+	scheduleEvent(e1Health.invulTime, TimedEventType::InvulnerableEnd, e1);
 
 	e1Health.health -= e2->get<CDamage>().damage;
 	e2Health.health -= e1->get<CDamage>().damage;
 
+	// popups, sound and knockback are resolved together in sDamage
+	DamageEvent event;
+	event.target = e1;
+	event.fromPos = e2->get<CTransform>().pos;
+	event.damage = e2->get<CDamage>().damage;
 	if (e2->has<CKnockback>())
 	{
 		auto& paKnockback = e2->get<CKnockback>();
-		applyKnockback(e1, e2->get<CTransform>().pos, paKnockback.magnitude, paKnockback.duration);
+		event.knockback = paKnockback.magnitude;
+		event.knockbackDuration = paKnockback.duration;
 	}
-	
-	spawnDisappearingText(std::to_string(e2->get<CDamage>().damage), e1->get<CTransform>().pos);
-	playSound("PlasticZap", 30);
+	m_damageEvents.push_back(event);
 	return true;
 }
 
+void Scene_Play::sDamage()
+{
+	if (m_damageEvents.empty())
+		return;
+
+	size_t newPopups = 0;
+	for (auto& event : m_damageEvents)
+	{
+		if (event.knockbackDuration > 0)
+		{
+			applyKnockback(event.target, event.fromPos, event.knockback, event.knockbackDuration);
+		}
+
+		// keep adding to a target's popup while it is still fresh instead of stacking new ones
+		auto& popup = m_damagePopups[event.target->id()];
+		if (popup.text && popup.text->isActive() && m_currentFrame - popup.frame < 20)
+		{
+			popup.total += event.damage;
+			popup.text->get<CDisappearingText>().text.setString(std::to_string(popup.total));
+		}
+		else if (newPopups < m_maxPopupsPerFrame)
+		{
+			popup.text = spawnDisappearingText(std::to_string(event.damage), event.target->get<CTransform>().pos);
+			popup.total = event.damage;
+			popup.frame = m_currentFrame;
+			newPopups++;
+		}
+	}
+
+	playSoundLimited(m_assetIds.plasticZap, 30, 3, m_damageEvents.front().target->get<CTransform>().pos);
+	m_damageEvents.clear();
+
+	for (auto it = m_damagePopups.begin(); it != m_damagePopups.end();)
+	{
+		if (!it->second.text || !it->second.text->isActive())
+			it = m_damagePopups.erase(it);
+		else
+			++it;
+	}
+}
+
+void Scene_Play::playSoundLimited(SoundId id, float volume, size_t minInterval, const Vec2f& pos)
+{
+	if (id.index >= m_lastSoundFrame.size())
+		m_lastSoundFrame.resize(id.index + 1, SIZE_MAX);
+	size_t& last = m_lastSoundFrame[id.index];
+	if (last != SIZE_MAX && m_currentFrame - last < minInterval)
+		return;
+
+	last = m_currentFrame;
+	playSound(id, volume, pos);
+}
+
 
 void Scene_Play::sCollision()
 {
-	for (auto& e1 : m_entityManager.getEntities("enemy"))
+	// enemies moved since sAI, so re-bucket them before the push-apart
+	auto& enemies = m_entityManager.getEntities("enemy");
+	gatherEnemyPositions();
+	m_flowField.bin(m_enemyPositions);
+	int enemyRings = m_flowField.cellsFor(2 * m_enemyMaxHalfSize);
+
+	// pack the enemy boxes in bin order, so each cell is a contiguous range
+	// that can be tested in one pass
+	auto& binned = m_flowField.binnedItems();
+	m_enemyBoxes.resize(enemies.size());
+	m_enemyPrevBoxes.resize(enemies.size());
+	m_enemySlots.resize(enemies.size());
+	m_enemyHalfSizes.assign(enemies.size(), Vec2f(0, 0));
+	m_enemyPushable.assign(enemies.size(), 0);
+	m_enemyStepped.assign(enemies.size(), 0);
+	for (size_t slot = 0; slot < binned.size(); slot++)
 	{
-		Vec2f overlap = Physics::GetOverlap(e1, player());
-		if (overlap.x > 0 && overlap.y > 0)
+		size_t i = binned[slot];
+		auto& enemy = enemies[i];
+		m_enemySlots[i] = slot;
+		if (enemy->has<CBoundingBox>())
+		{
+			auto& transform = enemy->get<CTransform>();
+			auto& halfSize = enemy->get<CBoundingBox>().halfSize;
+			m_enemyBoxes.set(slot, transform.pos, halfSize);
+			m_enemyPrevBoxes.set(slot, transform.prevPos, halfSize);
+			m_enemyHalfSizes[i] = halfSize;
+			m_enemyPushable[i] = (enemy->get<CBoundingBox>().mask & layerBit(CollisionLayer::Enemy)) != 0;
+			m_enemyStepped[i] = !enemy->has<CSimLod>() || enemy->get<CSimLod>().lastStep == m_currentFrame;
+		}
+		else
 		{
-			if (!applyDamage(e1, player())) continue;
+			m_enemyBoxes.setEmpty(slot);
+			m_enemyPrevBoxes.setEmpty(slot);
+		}
+	}
+
+	// Everything else with a collider, grouped by layer. Enemies and pickups
+	// are indexed by the flow field and the item grid instead.
+	for (auto& colliders : m_colliders)
+	{
+		colliders.clear();
+	}
+	for (auto& entity : m_entityManager.getEntities())
+	{
+		if (!entity->has<CBoundingBox>())
+			continue;
+		auto layer = entity->get<CBoundingBox>().layer;
+		if (layer != CollisionLayer::Enemy && layer != CollisionLayer::Pickup)
+			m_colliders[static_cast<size_t>(layer)].push_back(entity);
+	}
 
-			if (e1->get<CHealth>().health <= 0)
+	// every collider whose layer meets enemies, masked against all of them
+	m_enemyHitters.clear();
+	m_sweptHitters.clear();
+	size_t hitterCount = 0;
+	for (size_t l = 0; l < m_colliders.size(); l++)
+	{
+		if (!m_collisionMatrix.interacts(static_cast<CollisionLayer>(l), CollisionLayer::Enemy))
+			continue;
+		for (auto& collider : m_colliders[l])
+		{
+			auto& box = collider->get<CBoundingBox>();
+			if (!(box.mask & layerBit(CollisionLayer::Enemy)))
+				continue;
+			// moved more than half its size, so it could have stepped over an enemy
+			auto& transform = collider->get<CTransform>();
+			Vec2f travel = transform.pos - transform.prevPos;
+			if (std::abs(travel.x) > box.halfSize.x || std::abs(travel.y) > box.halfSize.y)
 			{
-				e1->get<CState>().state = "dead";
-				player()->get<CScore>().score += e1->get<CScore>().score;
+				m_sweptHitters.push_back(collider);
+				continue;
 			}
-			if (player()->get<CHealth>().health <= 0)
-			{
-				player()->get<CState>().state = "dead";
+			if (m_hitterMasks.size() <= hitterCount)
+				m_hitterMasks.resize(hitterCount + 1);
+			Physics::OverlapMask(collider->get<CTransform>().pos, box.halfSize, m_enemyBoxes, 0, enemies.size(),
+				m_hitterMasks[hitterCount++]);
+			m_enemyHitters.push_back(collider);
+		}
+	}
+
+	for (auto& hitter : m_sweptHitters)
+	{
+		if (sweepEnemyHits(hitter, enemies))
+			return;
+	}
+
+	for (size_t i = 0; i < enemies.size() && hitterCount > 0; i++)
+	{
+		auto& e1 = enemies[i];
+		if (!e1->has<CBoundingBox>())
+			continue;
+
+		size_t slot = m_enemySlots[i];
+		auto& e1Box = e1->get<CBoundingBox>();
+		for (size_t h = 0; h < hitterCount; h++)
+		{
+			auto& other = m_enemyHitters[h];
+			auto& otherBox = other->get<CBoundingBox>();
+			if (!Physics::HasHit(m_hitterMasks[h], slot) || !(e1Box.mask & layerBit(otherBox.layer)))
+				continue;
+			// the mask only tested bounding boxes
+			bool bothBoxes = e1Box.shape.type == ShapeType::Box && otherBox.shape.type == ShapeType::Box;
+			if (!bothBoxes && !Physics::ShapesOverlap(e1Box, e1->get<CTransform>().pos,
+				otherBox, other->get<CTransform>().pos))
+				continue;
+			if (applyEnemyHit(e1, other))
 				return;
-			}	
 		}
+	}
 
-		for (auto& pAttack : m_entityManager.getEntities("playerAttack"))
+	if (m_collisionMatrix.interacts(CollisionLayer::Enemy, CollisionLayer::Enemy))
+		resolveEnemyContacts(enemies, enemyRings);
+
+	// only items being pulled move, so only they need their cell refreshed
+	for (auto& item : m_awakeItems)
+	{
+		if (item->isActive())
+			m_itemGrid.move(item->get<CItem>().gridHandle, item->get<CTransform>().pos);
+	}
+
+	for (size_t l = 0; l < m_colliders.size(); l++)
+	{
+		auto layer = static_cast<CollisionLayer>(l);
+		if (!m_collisionMatrix.interacts(layer, CollisionLayer::Pickup))
+			continue;
+		for (auto& collector : m_colliders[l])
 		{
-			overlap = Physics::GetOverlap(e1, pAttack);
-			if (overlap.x > 0 && overlap.y > 0)
-			{
-				if (!applyDamage(e1, pAttack)) continue;
-			
-				if (e1->get<CHealth>().health <= 0)
-				{
-					e1->get<CState>().state = "dead";
-					player()->get<CScore>().score += e1->get<CScore>().score;
-				}
-				if (pAttack->get<CHealth>().health <= 0)
-				{
-					pAttack->destroy();
-				}
-			}
+			auto& box = collector->get<CBoundingBox>();
+			if (box.mask & layerBit(CollisionLayer::Pickup))
+				collectItems(collector);
 		}
+	}
+}
 
-		for (auto& e2 : m_entityManager.getEntities("enemy"))
+// Returns true when the hit killed the player.
+bool Scene_Play::applyEnemyHit(std::shared_ptr<Entity> enemy, std::shared_ptr<Entity> hitter)
+{
+	if (!applyDamage(enemy, hitter))
+		return false;
+
+	if (enemy->get<CHealth>().health <= 0)
+	{
+		enemy->get<CState>().state = "dead";
+		player()->get<CScore>().score += enemy->get<CScore>().score;
+	}
+	if (hitter->get<CHealth>().health <= 0)
+	{
+		if (hitter == player())
 		{
-			if (e1->id() == e2->id())
-				continue;
+			player()->get<CState>().state = "dead";
+			return true;
+		}
+		hitter->destroy();
+	}
+	return false;
+}
 
-			overlap = Physics::GetOverlap(e1, e2);
-			if (overlap.x > 0 && overlap.y > 0)
-			{
-				auto& e1Transform = e1->get<CTransform>();
-				auto& e2Transform = e2->get<CTransform>();
-				Vec2f prevOverlap = Physics::GetPreviousOverlap(e1, e2);
-				if (prevOverlap.x > 0)
-				{
-					e1Transform.velocity.y = 0;
-					if (e1Transform.prevPos.y < e2Transform.pos.y)
-						e1Transform.pos.y -= overlap.y;
-					else
-						e1Transform.pos.y += overlap.y;
-				}
-				else if (prevOverlap.y > 0)
-				{
-					e1Transform.velocity.x = 0;
-					if (e1Transform.prevPos.x < e2Transform.pos.x)
-						e1Transform.pos.x -= overlap.x;
-					else
-						e1Transform.pos.x += overlap.x;
-				}
-			}
+// A fast mover tests its whole path this tick instead of where it ended up:
+// candidates come from the packed boxes under the swept bounds, then each is
+// hit by a ray in path order until the mover is used up. The sweep uses the
+// bounding box, not the narrow-phase shape.
+bool Scene_Play::sweepEnemyHits(std::shared_ptr<Entity> hitter, const EntityVec& enemies)
+{
+	auto& transform = hitter->get<CTransform>();
+	auto& box = hitter->get<CBoundingBox>();
+	Vec2f travel = transform.pos - transform.prevPos;
+	Vec2f halfTravel(std::abs(travel.x) / 2, std::abs(travel.y) / 2);
+	Physics::OverlapMask(transform.prevPos + travel / 2, box.halfSize + halfTravel, m_enemyBoxes,
+		0, enemies.size(), m_sweepMask);
+
+	auto& binned = m_flowField.binnedItems();
+	m_sweepHits.clear();
+	Physics::ForEachHit(m_sweepMask, 0, [&](size_t slot)
+	{
+		size_t i = binned[slot];
+		auto& enemyBox = enemies[i]->get<CBoundingBox>();
+		if (!(enemyBox.mask & layerBit(box.layer)))
+			return;
+		auto hit = Physics::SweepBox(transform.prevPos, travel, box.halfSize,
+			enemies[i]->get<CTransform>().pos, enemyBox.halfSize);
+		if (hit.intersected)
+			m_sweepHits.emplace_back(transform.prevPos.distToSquared(hit.point), i);
+	});
+	std::sort(m_sweepHits.begin(), m_sweepHits.end());
+
+	for (auto& [distance, i] : m_sweepHits)
+	{
+		if (applyEnemyHit(enemies[i], hitter))
+			return true;
+		if (!hitter->isActive())
+			break;
+	}
+	return false;
+}
+
+// Enemy push-apart: detect contacts in fixed chunks on the pool, then apply
+// every correction at once. Each enemy only reads the packed boxes and
+// writes its own contacts, so the result does not depend on how many threads
+// ran or in what order.
+//
+// The pool also decodes assets, so a helper may sit behind a decode. The main
+// thread claims chunks too and never waits on a helper that hasn't started;
+// one that starts after every chunk is claimed returns without touching the
+// scene.
+void Scene_Play::resolveEnemyContacts(const EntityVec& enemies, int enemyRings)
+{
+	size_t chunkCount = (enemies.size() + m_contactChunk - 1) / m_contactChunk;
+	if (m_contactBuffers.size() < chunkCount)
+		m_contactBuffers.resize(chunkCount);
+
+	auto work = std::make_shared<ContactWork>();
+	work->count = chunkCount;
+	auto runChunks = [this, &enemies, enemyRings](ContactWork& work)
+	{
+		for (size_t c = work.next++; c < work.count; c = work.next++)
+		{
+			detectEnemyContacts(enemies, c * m_contactChunk, (c + 1) * m_contactChunk, enemyRings,
+				m_contactBuffers[c]);
+			work.done.fetch_add(1, std::memory_order_release);
 		}
+	};
+
+	size_t helpers = std::min(m_game->threadPool().size(), chunkCount > 0 ? chunkCount - 1 : 0);
+	for (size_t i = 0; i < helpers; i++)
+	{
+		m_game->threadPool().submit([work, runChunks] { runChunks(*work); });
+	}
+	runChunks(*work);
+	while (work->done.load(std::memory_order_acquire) < chunkCount)
+	{
+		std::this_thread::yield();
 	}
 
-	for (auto& gem : m_entityManager.getEntities("gem"))
+	for (size_t c = 0; c < chunkCount; c++)
 	{
-		Vec2f overlap = Physics::GetOverlap(gem, player());
-		if (overlap.x > 0 && overlap.y > 0)
+		for (auto& contact : m_contactBuffers[c].contacts)
 		{
-			auto& pScore = player()->get<CScore>().score;
-			auto& gemScore = gem->get<CScore>().score;
-			pScore += gemScore;
-			spawnDisappearingText("+" + std::to_string(gemScore), gem->get<CTransform>().pos);
-			playSound("CoinZap", 15);
-			gem->destroy();
+			auto& transform = enemies[contact.enemy]->get<CTransform>();
+			transform.pos += contact.push;
+			if (contact.stopX)
+				transform.velocity.x = 0;
+			if (contact.stopY)
+				transform.velocity.y = 0;
 		}
 	}
+}
 
-	for (auto& heart : m_entityManager.getEntities("heart"))
+void Scene_Play::collectItems(std::shared_ptr<Entity> collector)
+{
+	auto& cTransform = collector->get<CTransform>();
+	auto& cBox = collector->get<CBoundingBox>();
+	Vec2f reach = cBox.halfSize + Vec2f(m_itemMaxHalfSize, m_itemMaxHalfSize);
+	m_itemGrid.withinRadius(cTransform.pos, reach.length(), m_queryResults);
+	for (size_t handle : m_queryResults)
 	{
-		Vec2f overlap = Physics::GetOverlap(heart, player());
-		if (overlap.x > 0 && overlap.y > 0)
+		auto item = m_itemSlots[handle];
+		if (!(item->get<CBoundingBox>().mask & layerBit(cBox.layer)))
+			continue;
+		Vec2f overlap = Physics::GetOverlap(item, collector);
+		if (!(overlap.x > 0 && overlap.y > 0))
+			continue;
+
+		if (item->tag() == "gem")
 		{
-			auto& pHealth = player()->get<CHealth>();
-			auto& hHealth = heart->get<CHealth>().health;
-			pHealth.health = std::min(pHealth.health + hHealth, pHealth.maxHealth);
+			auto& cScore = collector->get<CScore>().score;
+			auto& gemScore = item->get<CScore>().score;
+			cScore += gemScore;
+			spawnDisappearingText("+" + std::to_string(gemScore), item->get<CTransform>().pos);
+		}
+		else
+		{
+			auto& cHealth = collector->get<CHealth>();
+			auto& hHealth = item->get<CHealth>().health;
+			cHealth.health = std::min(cHealth.health + hHealth, cHealth.maxHealth);
+			spawnDisappearingText("+" + std::to_string(hHealth), item->get<CTransform>().pos);
+		}
+		playSoundLimited(m_assetIds.coinZap, 15, 3, cTransform.pos);
+		removeItem(item);
+	}
+}
+
+// Contacts for enemies [begin, end). Both enemies of an overlapping pair see
+// each other, so each takes half of the push-out along the axis that was
+// already overlapping last frame.
+void Scene_Play::detectEnemyContacts(const EntityVec& enemies, size_t begin, size_t end, int rings,
+	ContactBuffer& buffer)
+{
+	auto& binned = m_flowField.binnedItems();
+	end = std::min(end, enemies.size());
+	buffer.contacts.clear();
+
+	for (size_t i = begin; i < end; i++)
+	{
+		// reduced-detail enemies are only separated on the ticks they move
+		if (!m_enemyPushable[i] || !m_enemyStepped[i])
+			continue;
 
-			spawnDisappearingText("+" + std::to_string(hHealth), heart->get<CTransform>().pos);
-			playSound("CoinZap", 15);
-			heart->destroy();
+		size_t slot = m_enemySlots[i];
+		const Vec2f& pos = m_enemyPositions[i];
+		const Vec2f& prevPos = enemies[i]->get<CTransform>().prevPos;
+		const Vec2f& halfSize = m_enemyHalfSizes[i];
+		m_flowField.forEachCellNear(pos, rings, [&](size_t cellBegin, size_t cellEnd)
+		{
+			Physics::OverlapMask(pos, halfSize, m_enemyBoxes, cellBegin, cellEnd, buffer.hits);
+			Physics::AxisOverlapMasks(prevPos, halfSize, m_enemyPrevBoxes, cellBegin, cellEnd,
+				buffer.prevHitsX, buffer.prevHitsY);
+			Physics::ForEachHit(buffer.hits, cellBegin, [&](size_t k)
+			{
+				if (k == slot)
+					return;
+
+				// Each side takes half of the push-out when both move. A neighbour
+				// that skips this contact (not pushable, or a reduced-detail enemy
+				// that did not step) leaves the whole overlap to this side.
+				size_t other = binned[k];
+				float share = m_enemyPushable[other] && m_enemyStepped[other] ? 0.5f : 1.0f;
+				const Vec2f& otherPos = m_enemyPositions[other];
+				Vec2f overlap = halfSize + m_enemyHalfSizes[other] -
+					Vec2f(std::abs(pos.x - otherPos.x), std::abs(pos.y - otherPos.y));
+
+				Contact contact;
+				contact.enemy = static_cast<uint32_t>(i);
+				if (Physics::HasHit(buffer.prevHitsX, k - cellBegin))
+				{
+					contact.stopY = true;
+					contact.push.y = (prevPos.y < otherPos.y ? -overlap.y : overlap.y) * share;
+				}
+				else if (Physics::HasHit(buffer.prevHitsY, k - cellBegin))
+				{
+					contact.stopX = true;
+					contact.push.x = (prevPos.x < otherPos.x ? -overlap.x : overlap.x) * share;
+				}
+				else
+				{
+					return;
+				}
+				buffer.contacts.push_back(contact);
+			});
+		});
+	}
+}
+
+void Scene_Play::sCoalesceGems()
+{
+	auto& gems = m_entityManager.getEntities("gem");
+	if (gems.size() <= m_maxGems)
+		return;
+
+	// merge resting gems that share a grid cell, doubling the cell size until
+	// there are comfortably fewer than the cap so this does not run every frame
+	size_t gemCount = gems.size();
+	size_t target = m_maxGems * 3 / 4;
+	std::unordered_map<uint64_t, std::shared_ptr<Entity>> survivors;
+	for (float cellSize = 64.f; gemCount > target && cellSize <= 8192.f; cellSize *= 2)
+	{
+		survivors.clear();
+		for (auto& gem : gems)
+		{
+			if (!gem->isActive() || gem->get<CItem>().awake)
+				continue;
+
+			auto& pos = gem->get<CTransform>().pos;
+			int cx = static_cast<int>(std::floor(pos.x / cellSize));
+			int cy = static_cast<int>(std::floor(pos.y / cellSize));
+			uint64_t cell = (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+
+			auto [it, inserted] = survivors.try_emplace(cell, gem);
+			if (inserted)
+				continue;
+
+			mergeGem(it->second, gem);
+			if (--gemCount <= target)
+				break;
 		}
 	}
 }
 
-void Scene_Play::spawnDisappearingText(const std::string& text, const Vec2f& pos) {
+std::shared_ptr<Entity> Scene_Play::spawnDisappearingText(const std::string& text, const Vec2f& pos) {
 	// damage number pop up
-	sf::Text damageNumText(m_game->assets().getFont("FutureMillennium"));
+	sf::Text damageNumText(m_game->assets().getFont(m_assetIds.futureMillennium));
 	damageNumText.setString(text);
 	damageNumText.setCharacterSize(16);
 	damageNumText.setOutlineColor(sf::Color(86, 106, 137));
@@ -599,22 +1164,61 @@ void Scene_Play::spawnDisappearingText(const std::string& text, const Vec2f& pos
 	auto disappearingText = m_entityManager.addEntity("disappearingText", "disappearingText");
 	auto& dmComponent = disappearingText->add<CDisappearingText>(damageNumText);
 	disappearingText->add<CTransform>(enemyPosition, dmComponent.velocity);
-	disappearingText->add<CLifespan>(dmComponent.lifetime, m_currentFrame);
+	addLifespan(disappearingText, dmComponent.lifetime);
+	return disappearingText;
 }
 
 
-void Scene_Play::sLifespan()
+void Scene_Play::scheduleEvent(int delay, TimedEventType type, std::shared_ptr<Entity> entity, int data)
 {
-	for (auto& entity : m_entityManager.getEntities())
-	{
-		if (!entity->has<CLifespan>())
-			continue;
+	TimedEvent event;
+	event.type = type;
+	event.entity = entity;
+	event.data = data;
+	m_timers.schedule(m_currentFrame + delay, event);
+}
+
+void Scene_Play::addLifespan(std::shared_ptr<Entity> entity, int lifespan)
+{
+	entity->add<CLifespan>(lifespan, m_currentFrame);
+	scheduleEvent(lifespan + 1, TimedEventType::LifespanEnd, entity);
+}
+
+void Scene_Play::startCooldown(Weapon weapon, int cooldown)
+{
+	scheduleEvent(cooldown, TimedEventType::CooldownReady, player(), static_cast<int>(weapon));
+}
+
+void Scene_Play::sTimers()
+{
+	m_timers.advance(m_currentFrame, [this](const TimedEvent& event) { onTimedEvent(event); });
+}
 
-		auto& eLifespan = entity->get<CLifespan>();
-		if (m_currentFrame - eLifespan.frameCreated > eLifespan.lifespan)
+void Scene_Play::onTimedEvent(const TimedEvent& event)
+{
+	auto& entity = event.entity;
+	switch (event.type)
+	{
+	case TimedEventType::LifespanEnd:
+		entity->destroy();
+		break;
+	case TimedEventType::KnockbackEnd:
+		endKnockback(entity);
+		break;
+	case TimedEventType::InvulnerableEnd:
+		entity->get<CHealth>().invulnerable = false;
+		break;
+	case TimedEventType::CooldownReady:
+		switch (static_cast<Weapon>(event.data))
 		{
-			entity->destroy();
+		case Weapon::Basic:   entity->get<CBasicAttack>().ready = true; break;
+		case Weapon::Special: entity->get<CSpecialAttack>().ready = true; break;
+		case Weapon::Bullet:  entity->get<CBulletAttack>().ready = true; break;
+		case Weapon::Ring:    entity->get<CRingAttack>().ready = true; break;
+		case Weapon::Explode: entity->get<CExplodeAttack>().ready = true; break;
+		case Weapon::Whirl:   entity->get<CWhirlAttack>().ready = true; break;
 		}
+		break;
 	}
 }
 
@@ -647,7 +1251,7 @@ void Scene_Play::sPlayerAttacks()
 	Vec2f attackPos = Vec2f(0, 0);
 	if (pInput.autoAim)
 	{
-		auto nearestEnemy = getNearestEnemy(player());
+		auto nearestEnemy = getNearestEnemy(player(), pInput.autoAimRange);
 		if (nearestEnemy)
 			attackPos = nearestEnemy->get<CTransform>().pos;
 	}
@@ -688,9 +1292,11 @@ void Scene_Play::spawnBasicAttack(const Vec2f& targetPos)
 		return;
 
 	auto& pBasicAttack = player()->get<CBasicAttack>();
-	if ((m_currentFrame - pBasicAttack.lastAttackTime) < pBasicAttack.cooldown)
+	if (!pBasicAttack.ready)
 		return;
+	pBasicAttack.ready = false;
 	pBasicAttack.lastAttackTime = m_currentFrame;
+	startCooldown(Weapon::Basic, pBasicAttack.cooldown);
 
 	auto& pTransform = player()->get<CTransform>();
 
@@ -702,17 +1308,19 @@ void Scene_Play::spawnBasicAttack(const Vec2f& targetPos)
 		, Vec2f(0, 0), attackAngle);
 	baTransform.scale = pBasicAttack.scale;
 
-	auto& baAnimation = basicAttack->add<CAnimation>(m_game->assets().getAnimation("Slash1"), true).animation;
+	auto& baAnimation = basicAttack->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.slash1), true).animation;
 	baAnimation.m_sprite.setScale({ pBasicAttack.scale, pBasicAttack.scale });
 
-	basicAttack->add<CBoundingBox>(Vec2f(baAnimation.m_size.x, baAnimation.m_size.y / 2) * pBasicAttack.scale);
-	basicAttack->add<CLifespan>(pBasicAttack.duration, m_currentFrame);
+	basicAttack->add<CBoundingBox>(ColliderShape::orientedBox(
+		Vec2f(baAnimation.m_size.x, baAnimation.m_size.y / 2) * (pBasicAttack.scale / 2), attackAngle),
+		CollisionLayer::PlayerAttack);
+	addLifespan(basicAttack, pBasicAttack.duration);
 	basicAttack->add<CHealth>(pBasicAttack.health);
 	basicAttack->add<CMoveAtSameVelocity>(player());
 	basicAttack->add<CKnockback>(pBasicAttack.knockMagnitude, pBasicAttack.knockDuration);
 	basicAttack->add<CDamage>(pBasicAttack.damage);
 
-	playSound("SwordSlash", 30);
+	playSound(m_assetIds.swordSlash, 30);
 }
 
 void Scene_Play::spawnSpecialAttack(const Vec2f& targetPos)
@@ -721,9 +1329,11 @@ void Scene_Play::spawnSpecialAttack(const Vec2f& targetPos)
 		return;
 
 	auto& pSpecialAttack = player()->get<CSpecialAttack>();
-	if ((m_currentFrame - pSpecialAttack.lastAttackTime) < pSpecialAttack.cooldown)
+	if (!pSpecialAttack.ready)
 		return;
+	pSpecialAttack.ready = false;
 	pSpecialAttack.lastAttackTime = m_currentFrame;
+	startCooldown(Weapon::Special, pSpecialAttack.cooldown);
 
 	auto& pTransform = player()->get<CTransform>();
 
@@ -736,16 +1346,19 @@ void Scene_Play::spawnSpecialAttack(const Vec2f& targetPos)
 	saTransform.accel = pSpecialAttack.decel;
 	saTransform.scale = pSpecialAttack.scale;
 
-	auto& saAnimation = specialAttack->add<CAnimation>(m_game->assets().getAnimation("Slash1"), true).animation;
+	auto& saAnimation = specialAttack->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.slash1), true).animation;
 	saAnimation.m_sprite.setScale({ pSpecialAttack.scale, pSpecialAttack.scale });
 
-	specialAttack->add<CBoundingBox>(Vec2f(saAnimation.m_size.x, saAnimation.m_size.y / 2) * pSpecialAttack.scale);
-	specialAttack->add<CLifespan>(pSpecialAttack.duration, m_currentFrame);
+	float saRadius = saAnimation.m_size.y / 4 * pSpecialAttack.scale;
+	specialAttack->add<CBoundingBox>(ColliderShape::capsule(
+		std::max(saAnimation.m_size.x / 2 * pSpecialAttack.scale - saRadius, 0.0f), saRadius, attackAngle),
+		CollisionLayer::PlayerAttack);
+	addLifespan(specialAttack, pSpecialAttack.duration);
 	specialAttack->add<CHealth>(pSpecialAttack.health);
 	specialAttack->add<CKnockback>(pSpecialAttack.knockMagnitude, pSpecialAttack.knockDuration);
 	specialAttack->add<CDamage>(pSpecialAttack.damage);
 
-	playSound("HighWhoosh", 50);
+	playSound(m_assetIds.highWhoosh, 50);
 }
 
 void Scene_Play::spawnBulletAttack(const Vec2f& targetPos)
@@ -754,9 +1367,11 @@ void Scene_Play::spawnBulletAttack(const Vec2f& targetPos)
 		return;
 
 	auto& pBulletAttack = player()->get<CBulletAttack>();
-	if ((m_currentFrame - pBulletAttack.lastAttackTime) < pBulletAttack.cooldown)
+	if (!pBulletAttack.ready)
 		return;
+	pBulletAttack.ready = false;
 	pBulletAttack.lastAttackTime = m_currentFrame;
+	startCooldown(Weapon::Bullet, pBulletAttack.cooldown);
 
 	auto& pTransform = player()->get<CTransform>();
 
@@ -769,16 +1384,19 @@ void Scene_Play::spawnBulletAttack(const Vec2f& targetPos)
 	bulletTransform.accel = pBulletAttack.decel;
 	bulletTransform.scale = pBulletAttack.scale;
 
-	auto& saAnimation = bulletAttack->add<CAnimation>(m_game->assets().getAnimation("Bullet1"), true).animation;
+	auto& saAnimation = bulletAttack->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.bullet1), true).animation;
 	saAnimation.m_sprite.setScale({ pBulletAttack.scale, pBulletAttack.scale });
 
-	bulletAttack->add<CBoundingBox>(Vec2f(saAnimation.m_size.x, saAnimation.m_size.y / 4) * pBulletAttack.scale);
-	bulletAttack->add<CLifespan>(pBulletAttack.duration, m_currentFrame);
+	float bulletRadius = saAnimation.m_size.y / 8 * pBulletAttack.scale;
+	bulletAttack->add<CBoundingBox>(ColliderShape::capsule(
+		std::max(saAnimation.m_size.x / 2 * pBulletAttack.scale - bulletRadius, 0.0f), bulletRadius, attackAngle),
+		CollisionLayer::PlayerAttack);
+	addLifespan(bulletAttack, pBulletAttack.duration);
 	bulletAttack->add<CHealth>(pBulletAttack.health);
 	bulletAttack->add<CKnockback>(pBulletAttack.knockMagnitude, pBulletAttack.knockDuration);
 	bulletAttack->add<CDamage>(pBulletAttack.damage);
 
-	playSound("LaserShot", 5);
+	playSound(m_assetIds.laserShot, 5);
 }
 
 void Scene_Play::spawnRingAttack(const Vec2f& targetPos)
@@ -787,23 +1405,26 @@ void Scene_Play::spawnRingAttack(const Vec2f& targetPos)
 		return;
 
 	auto& pRingAttack = player()->get<CRingAttack>();
-	if ((m_currentFrame - pRingAttack.lastAttackTime) < pRingAttack.cooldown)
+	if (!pRingAttack.ready)
 		return;
+	pRingAttack.ready = false;
 	pRingAttack.lastAttackTime = m_currentFrame;
+	startCooldown(Weapon::Ring, pRingAttack.cooldown);
 
 	auto ringAttack = m_entityManager.addEntity("playerAttack", "ringAttack");
 	auto& ringTransform = ringAttack->add<CTransform>(targetPos);
 	ringTransform.scale = pRingAttack.scale;
-	auto& ringAnimation = ringAttack->add<CAnimation>(m_game->assets().getAnimation("Ring1"), true).animation;
+	auto& ringAnimation = ringAttack->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.ring1), true).animation;
 
-	ringAttack->add<CBoundingBox>(Vec2f(ringAnimation.m_size.x, ringAnimation.m_size.y) * pRingAttack.scale);
-	ringAttack->add<CLifespan>(pRingAttack.duration, m_currentFrame);
+	ringAttack->add<CBoundingBox>(ColliderShape::circle(ringAnimation.m_size.x / 2 * pRingAttack.scale),
+		CollisionLayer::PlayerAttack);
+	addLifespan(ringAttack, pRingAttack.duration);
 	ringAttack->add<CHealth>(pRingAttack.health);
 	ringAttack->add<CDamage>(pRingAttack.damage);
 	ringAttack->add<CMoveAtSameVelocity>(player());
 	ringAttack->add<CKnockback>(pRingAttack.knockMagnitude, pRingAttack.knockDuration);
 
-	playSound("FireSphere", 30);
+	playSound(m_assetIds.fireSphere, 30);
 }
 
 void Scene_Play::spawnExplodeAttack(const Vec2f& targetPos)
@@ -812,22 +1433,25 @@ void Scene_Play::spawnExplodeAttack(const Vec2f& targetPos)
 		return;
 
 	auto& pExplodeAttack = player()->get<CExplodeAttack>();
-	if ((m_currentFrame - pExplodeAttack.lastAttackTime) < pExplodeAttack.cooldown)
+	if (!pExplodeAttack.ready)
 		return;
+	pExplodeAttack.ready = false;
 	pExplodeAttack.lastAttackTime = m_currentFrame;
+	startCooldown(Weapon::Explode, pExplodeAttack.cooldown);
 
 	auto explodeAttack = m_entityManager.addEntity("playerAttack", "explodeAttack");
 	auto& ringTransform = explodeAttack->add<CTransform>(targetPos);
 	ringTransform.scale = pExplodeAttack.scale;
-	auto& ringAnimation = explodeAttack->add<CAnimation>(m_game->assets().getAnimation("Explode1"), true).animation;
+	auto& ringAnimation = explodeAttack->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.explode1), true).animation;
 
-	explodeAttack->add<CBoundingBox>(Vec2f(ringAnimation.m_size.x, ringAnimation.m_size.y) / 2 * pExplodeAttack.scale);
-	explodeAttack->add<CLifespan>(pExplodeAttack.duration, m_currentFrame);
+	explodeAttack->add<CBoundingBox>(ColliderShape::circle(ringAnimation.m_size.x / 4 * pExplodeAttack.scale),
+		CollisionLayer::PlayerAttack);
+	addLifespan(explodeAttack, pExplodeAttack.duration);
 	explodeAttack->add<CHealth>(pExplodeAttack.health);
 	explodeAttack->add<CDamage>(pExplodeAttack.damage);
 	explodeAttack->add<CKnockback>(pExplodeAttack.knockMagnitude, pExplodeAttack.knockDuration);
 
-	playSound("FireHit", 50);
+	playSound(m_assetIds.fireHit, 50);
 }
 
 void Scene_Play::spawnWhirlAttack(const Vec2f& targetPos)
@@ -836,54 +1460,68 @@ void Scene_Play::spawnWhirlAttack(const Vec2f& targetPos)
 		return;
 
 	auto& pWhirlAttack = player()->get<CWhirlAttack>();
-	if ((m_currentFrame - pWhirlAttack.lastAttackTime) < pWhirlAttack.cooldown)
+	if (!pWhirlAttack.ready)
 		return;
+	pWhirlAttack.ready = false;
 	pWhirlAttack.lastAttackTime = m_currentFrame;
+	startCooldown(Weapon::Whirl, pWhirlAttack.cooldown);
 
 	auto whirlAttack = m_entityManager.addEntity("playerAttack", "whirlAttack");
 	auto& ringTransform = whirlAttack->add<CTransform>(targetPos);
 	ringTransform.scale = pWhirlAttack.scale;
-	auto& ringAnimation = whirlAttack->add<CAnimation>(m_game->assets().getAnimation("Ring2"), true).animation;
+	auto& ringAnimation = whirlAttack->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.ring2), true).animation;
 
-	whirlAttack->add<CBoundingBox>(Vec2f(ringAnimation.m_size.x, ringAnimation.m_size.y) * pWhirlAttack.scale);
-	whirlAttack->add<CLifespan>(pWhirlAttack.duration, m_currentFrame);
+	whirlAttack->add<CBoundingBox>(ColliderShape::circle(ringAnimation.m_size.x / 2 * pWhirlAttack.scale),
+		CollisionLayer::PlayerAttack);
+	addLifespan(whirlAttack, pWhirlAttack.duration);
 	whirlAttack->add<CHealth>(pWhirlAttack.health);
 	whirlAttack->add<CDamage>(pWhirlAttack.damage);
 	whirlAttack->add<CAttractor>(pWhirlAttack.attractStrength, pWhirlAttack.attractRadius);
 	whirlAttack->add<CKnockback>(pWhirlAttack.knockMagnitude, pWhirlAttack.knockDuration);
 
-	playSound("FireHit", 50);
+	playSound(m_assetIds.fireHit, 50);
 }
 
 void Scene_Play::sAttraction()
 {
+	auto& enemies = m_entityManager.getEntities("enemy");
 	for (auto& attractor : m_entityManager.getEntities("playerAttack")) {
 		if (!attractor->has<CAttractor>()) continue;
 
-		for (auto& target : m_entityManager.getEntities("enemy"))
+		auto& attract = attractor->get<CAttractor>();
+		m_enemyGrid.withinRadius(attractor->get<CTransform>().pos, attract.radius, m_queryResults);
+		for (size_t i : m_queryResults)
 		{
-			applyAttraction(attractor, target);
+			applyAttraction(attractor, enemies[i]);
 		}
 	}
 
+	for (auto& item : m_awakeItems)
+	{
+		item->get<CItem>().awake = false;
+	}
+
+	m_nextAwakeItems.clear();
 	if (player()->has<CAttractor>())
 	{
-		for (auto& gem : m_entityManager.getEntities("gem"))
+		auto& attract = player()->get<CAttractor>();
+		m_itemGrid.withinRadius(player()->get<CTransform>().pos, attract.radius, m_queryResults);
+		for (size_t handle : m_queryResults)
 		{
-			if (!applyAttraction(player(), gem))
-			{
-				gem->get<CTransform>().velocity = Vec2f(0, 0);
-			}
+			auto& item = m_itemSlots[handle];
+			applyAttraction(player(), item);
+			item->get<CItem>().awake = true;
+			m_nextAwakeItems.push_back(item);
 		}
+	}
 
-		for (auto& heart : m_entityManager.getEntities("heart"))
-		{
-			if (!applyAttraction(player(), heart))
-			{
-				heart->get<CTransform>().velocity = Vec2f(0, 0);
-			}
-		}
-	}	
+	// items that left the magnet this frame stop; the rest were never touched
+	for (auto& item : m_awakeItems)
+	{
+		if (item->isActive() && !item->get<CItem>().awake)
+			item->get<CTransform>().velocity = Vec2f(0, 0);
+	}
+	std::swap(m_awakeItems, m_nextAwakeItems);
 }
 
 bool Scene_Play::applyAttraction(std::shared_ptr<Entity> attractor, std::shared_ptr<Entity> target) {
@@ -916,78 +1554,64 @@ bool Scene_Play::applyAttraction(std::shared_ptr<Entity> attractor, std::shared_
 void Scene_Play::sDoAction(const Action& action)
 {
 	auto& pInput = player()->get<CInput>();
-	if (action.m_type == "START")
-	{
-		if (action.m_name == "LEFT")
-			pInput.left = true;
-		else if (action.m_name == "RIGHT")
-			pInput.right = true;
-		else if (action.m_name == "UP")
-			pInput.up = true;
-		else if (action.m_name == "DOWN")
-			pInput.down = true;
-		else if (action.m_name == "ESCAPE")
+	if (action.m_type == ActionType::START)
+	{
+		switch (action.m_name)
 		{
+		case ActionName::LEFT:  pInput.left = true; break;
+		case ActionName::RIGHT: pInput.right = true; break;
+		case ActionName::UP:    pInput.up = true; break;
+		case ActionName::DOWN:  pInput.down = true; break;
+		case ActionName::ESCAPE:
 			onExitScene();
 			m_game->changeScene("PAUSE", std::make_shared<Scene_Pause>(m_game));
-		}	
-		else if (action.m_name == "NEW_WEAPON")
-		{
+			break;
+		case ActionName::NEW_WEAPON:
 			onExitScene();
 			m_game->changeScene("NEW_WEAPON", std::make_shared<Scene_NewWeapon>(m_game, player()));
-		}
-		else if (action.m_name == "LEVEL_WEAPON")
-		{
+			break;
+		case ActionName::LEVEL_WEAPON:
 			onExitScene();
 			m_game->changeScene("LEVEL_WEAPON", std::make_shared<Scene_LevelWeapon>(m_game, player()));
-		}
-		else if (action.m_name == "DISPLAY_HITBOX")
+			break;
+		case ActionName::DISPLAY_HITBOX:
 			pInput.displayHitbox = !pInput.displayHitbox;
-		else if (action.m_name == "LEFT_CLICK")
-		{
+			break;
+		case ActionName::LEFT_CLICK:
 			pInput.basicAttack = true;
-			m_mousePos = m_game->window().mapPixelToCoords(action.m_mousePos);
+			m_mousePos = mapPixelToView(action.m_mousePos, m_cameraView);
+			break;
+		case ActionName::RIGHT_CLICK:
+			pInput.specialAttack = true;
+			m_mousePos = mapPixelToView(action.m_mousePos, m_cameraView);
+			break;
+		case ActionName::MOUSE_MOVE:
+			m_mousePos = mapPixelToView(action.m_mousePos, m_cameraView);
+			break;
+		case ActionName::TOGGLE_AUTO_ATTACK: pInput.autoAttack = !pInput.autoAttack; break;
+		case ActionName::TOGGLE_AUTO_AIM:    pInput.autoAim = !pInput.autoAim; break;
+		case ActionName::RING_ATTACK:        pInput.ringAttack = !pInput.ringAttack; break;
+		case ActionName::EXPLODE_ATTACK:     pInput.explodeAttack = true; break;
+		case ActionName::WHIRL_ATTACK:       pInput.whirlAttack = true; break;
+		case ActionName::BULLET_ATTACK:      pInput.bulletAttack = true; break;
+		default: break;
 		}
-		else if (action.m_name == "RIGHT_CLICK")
+	}
+	else if (action.m_type == ActionType::END)
+	{
+		switch (action.m_name)
 		{
-			pInput.specialAttack = true;
-			m_mousePos = m_game->window().mapPixelToCoords(action.m_mousePos);
+		case ActionName::LEFT:           pInput.left = false; break;
+		case ActionName::RIGHT:          pInput.right = false; break;
+		case ActionName::UP:             pInput.up = false; break;
+		case ActionName::DOWN:           pInput.down = false; break;
+		case ActionName::LEFT_CLICK:     pInput.basicAttack = false; break;
+		case ActionName::RIGHT_CLICK:    pInput.specialAttack = false; break;
+		case ActionName::EXPLODE_ATTACK: pInput.explodeAttack = false; break;
+		case ActionName::WHIRL_ATTACK:   pInput.whirlAttack = false; break;
+		case ActionName::BULLET_ATTACK:  pInput.bulletAttack = false; break;
+		default: break;
 		}
-		else if (action.m_name == "MOUSE_MOVE")
-			m_mousePos = m_game->window().mapPixelToCoords(action.m_mousePos);
-		else if (action.m_name == "TOGGLE_AUTO_ATTACK")
-			pInput.autoAttack = !pInput.autoAttack;
-		else if (action.m_name == "TOGGLE_AUTO_AIM")
-			pInput.autoAim = !pInput.autoAim;
-		else if (action.m_name == "RING_ATTACK")
-			pInput.ringAttack = !pInput.ringAttack;
-		else if (action.m_name == "EXPLODE_ATTACK")
-			pInput.explodeAttack = true;
-		else if (action.m_name == "WHIRL_ATTACK")
-			pInput.whirlAttack = true;
-		else if (action.m_name == "BULLET_ATTACK")
-			pInput.bulletAttack = true;
-	}
-	else if (action.m_type == "END")
-	{
-		if (action.m_name == "LEFT")
-			pInput.left = false;
-		else if (action.m_name == "RIGHT")
-			pInput.right = false;
-		if (action.m_name == "UP")
-			pInput.up = false;
-		else if (action.m_name == "DOWN")
-			pInput.down = false;
-		else if (action.m_name == "LEFT_CLICK")
-			pInput.basicAttack = false;
-		else if (action.m_name == "RIGHT_CLICK")
-			pInput.specialAttack = false;
-		else if (action.m_name == "EXPLODE_ATTACK")
-			pInput.explodeAttack = false;
-		else if (action.m_name == "WHIRL_ATTACK")
-			pInput.whirlAttack = false;
-		else if (action.m_name == "BULLET_ATTACK")
-			pInput.bulletAttack = false;
 	}
 }
 
@@ -998,8 +1622,10 @@ void Scene_Play::sAnimation()
 		if (!entity->has<CAnimation>())
 			continue;
 
+		// off-screen enemies hold their frame until they come back into view
 		auto& eAnimation = entity->get<CAnimation>();
-		eAnimation.animation.update();
+		if (!entity->has<CSimLod>() || entity->get<CSimLod>().stride == 1)
+			eAnimation.animation.update();
 
 		if (!eAnimation.repeat && eAnimation.animation.hasEnded())
 		{
@@ -1011,58 +1637,39 @@ void Scene_Play::sAnimation()
 		{
 			auto& pState = player()->get<CState>().state;
 			auto& pAnimation = player()->get<CAnimation>().animation;
-			if (pState == "idle" && pAnimation.m_name != "StormheadIdle")
+			if (pState == "idle" && pAnimation.m_id != m_assetIds.stormheadIdle)
 			{
-				player()->add<CAnimation>(m_game->assets().getAnimation("StormheadIdle"), true);
+				player()->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.stormheadIdle), true);
 			}
-			else if (pState == "running" && pAnimation.m_name != "StormheadRun")
+			else if (pState == "running" && pAnimation.m_id != m_assetIds.stormheadRun)
 			{
-				player()->add<CAnimation>(m_game->assets().getAnimation("StormheadRun"), true);
+				player()->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.stormheadRun), true);
 			}
-			else if (pState == "dead" && pAnimation.m_name != "StormheadDeath")
+			else if (pState == "dead" && pAnimation.m_id != m_assetIds.stormheadDeath)
 			{
-				player()->add<CAnimation>(m_game->assets().getAnimation("StormheadDeath"), false);
+				player()->add<CAnimation>(m_game->assets().getAnimation(m_assetIds.stormheadDeath), false);
 				m_playerDied = true;
 			}
 		}
 
-		if (entity->tag() == "enemy")
+		if (entity->tag() == "enemy" && entity->has<CArchetype>())
 		{
-			if (entity->name() == "chainBot")
+			auto& type = m_enemyTypes[entity->get<CArchetype>().index];
+			auto& eState = entity->get<CState>().state;
+			AnimationId current = entity->get<CAnimation>().animation.m_id;
+			if (eState == "alive" && current != type.idle)
 			{
-				auto& eState = entity->get<CState>().state;
-				if (eState == "alive" && entity->get<CAnimation>().animation.m_name != "ChainBotIdle")
-				{
-					auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation("ChainBotIdle"), true);
-				}
-				else if (eState == "knockback" && entity->get<CAnimation>().animation.m_name != "ChainBotHit")
-				{
-					auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation("ChainBotHit"), true);
-				}
-				else if (eState == "dead" && entity->get<CAnimation>().animation.m_name != "ChainBotDeath")
-				{
-					auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation("ChainBotDeath"), false);
-					eAnimation.animation.m_sprite.setColor(sf::Color::Green);
-					enemyDied(entity);
-				}
+				entity->add<CAnimation>(m_game->assets().getAnimation(type.idle), true);
 			}
-			else if (entity->name() == "botWheel")
+			else if (eState == "knockback" && current != type.hit)
 			{
-				auto& eState = entity->get<CState>().state;
-				if (eState == "alive" && entity->get<CAnimation>().animation.m_name != "BotWheelRun")
-				{
-					auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation("BotWheelRun"), true);
-				}
-				else if (eState == "knockback" && entity->get<CAnimation>().animation.m_name != "BotWheelHit")
-				{
-					auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation("BotWheelHit"), true);
-				}
-				else if (eState == "dead" && entity->get<CAnimation>().animation.m_name != "BotWheelDead")
-				{
-					auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation("BotWheelDead"), false);
-					eAnimation.animation.m_sprite.setColor(sf::Color::Green);
-					enemyDied(entity);
-				}
+				entity->add<CAnimation>(m_game->assets().getAnimation(type.hit), true);
+			}
+			else if (eState == "dead" && current != type.death)
+			{
+				auto& eAnimation = entity->add<CAnimation>(m_game->assets().getAnimation(type.death), false);
+				eAnimation.animation.m_sprite.setColor(sf::Color::Green);
+				enemyDied(entity);
 			}
 		}
 	}
@@ -1076,13 +1683,13 @@ void Scene_Play::enemyDied(std::shared_ptr<Entity> enemy)
 	enemy->remove<CBoundingBox>();
 	eTransform.velocity = { 0, 0 };
 
-	playSound("LaserPebble", 40);
+	playSoundLimited(m_assetIds.laserPebble, 40, 3, eTransform.pos);
 	for (int i = 0; i < enemy->get<CScore>().score; i++)
 	{
 		spawnGem(eTransform.pos);
 	}
 
-	if (rand() % 100 == 0)
+	if (m_game->random().stream(RngStream::Loot).chance(0.01f))
 	{
 		spawnHeart(eTransform.pos);
 	}
@@ -1093,7 +1700,7 @@ void Scene_Play::sSound()
 	auto& pState = player()->get<CState>().state;
 	if (pState == "running" && m_currentFrame % 15 == 0)
 	{
-		playSound("BubbleStep", 5);
+		playSound(m_assetIds.bubbleStep, 5);
 	}
 }
 
@@ -1102,6 +1709,7 @@ void Scene_Play::sCamera()
 	auto& pTransform = player()->get<CTransform>();
 	m_cameraView.setCenter(pTransform.pos);
 	m_game->window().setView(m_cameraView);
+	m_game->sound().setListener(pTransform.pos);
 }
 
 void Scene_Play::onEnd()
@@ -1143,6 +1751,55 @@ void Scene_Play::renderShadow(std::shared_ptr<Entity> entity)
 	m_game->window().draw(shadow);
 }
 
+// outline of the narrow-phase shape, over the bounding box
+void Scene_Play::drawColliderShape(const ColliderShape& shape, const Vec2f& pos)
+{
+	auto& window = m_game->window();
+	auto outline = [&](sf::Shape& drawn, const Vec2f& at)
+	{
+		drawn.setPosition(at);
+		drawn.setFillColor(sf::Color(255, 255, 0, 40));
+		drawn.setOutlineColor(sf::Color::Yellow);
+		drawn.setOutlineThickness(1.f);
+		window.draw(drawn);
+	};
+
+	switch (shape.type)
+	{
+	case ShapeType::Circle:
+	{
+		sf::CircleShape circle(shape.radius);
+		circle.setOrigin({ shape.radius, shape.radius });
+		outline(circle, pos);
+		break;
+	}
+	case ShapeType::Capsule:
+	{
+		sf::RectangleShape body(Vec2f(shape.halfLength * 2, shape.radius * 2));
+		body.setOrigin({ shape.halfLength, shape.radius });
+		body.setRotation(sf::degrees(shape.angleDegrees()));
+		outline(body, pos);
+		for (float side : { -1.0f, 1.0f })
+		{
+			sf::CircleShape cap(shape.radius);
+			cap.setOrigin({ shape.radius, shape.radius });
+			outline(cap, pos + shape.axis * (shape.halfLength * side));
+		}
+		break;
+	}
+	case ShapeType::OrientedBox:
+	{
+		sf::RectangleShape box(shape.halfExtents * 2);
+		box.setOrigin(shape.halfExtents);
+		box.setRotation(sf::degrees(shape.angleDegrees()));
+		outline(box, pos);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
 
 void Scene_Play::sRender()
 {
@@ -1242,6 +1899,7 @@ void Scene_Play::sRender()
 			hitbox.setOutlineColor(sf::Color::Red);
 			hitbox.setOutlineThickness(1.f);
 			window.draw(hitbox);
+			drawColliderShape(boundingBox.shape, transform.pos);
 		}
 	}
 	
@@ -1267,7 +1925,7 @@ void Scene_Play::sRender()
 	timeStream << std::setw(2) << std::setfill('0') << minutes
 		<< ":" << std::setw(2) << std::setfill('0') << seconds;
 
-	sf::Text timerText(m_game->assets().getFont("FutureMillennium"));
+	sf::Text timerText(m_game->assets().getFont(m_assetIds.futureMillennium));
 	timerText.setCharacterSize(100);
 	timerText.setString(timeStream.str());
 	timerText.setOutlineThickness(3.0f);
@@ -1281,7 +1939,7 @@ void Scene_Play::sRender()
 	//
 	
 	// player score
-	sf::Text scoreText(m_game->assets().getFont("FutureMillennium"));
+	sf::Text scoreText(m_game->assets().getFont(m_assetIds.futureMillennium));
 	scoreText.setCharacterSize(100);
 	scoreText.setOutlineThickness(3.0f);
 	scoreText.setOutlineColor(sf::Color(86, 106, 137));
@@ -1317,7 +1975,7 @@ void Scene_Play::sRender()
 	//
 
 	// player health text
-	sf::Text healthText(m_game->assets().getFont("FutureMillennium"));
+	sf::Text healthText(m_game->assets().getFont(m_assetIds.futureMillennium));
 	healthText.setCharacterSize(40.f);
 	healthText.setOutlineThickness(1.0f);
 	healthText.setOutlineColor(sf::Color(86, 106, 137));
@@ -1330,7 +1988,7 @@ void Scene_Play::sRender()
 	//
 
 	// player level text
-	sf::Text levelText(m_game->assets().getFont("FutureMillennium"));
+	sf::Text levelText(m_game->assets().getFont(m_assetIds.futureMillennium));
 	levelText.setCharacterSize(40.f);
 	levelText.setOutlineThickness(1.0f);
 	levelText.setOutlineColor(sf::Color(86, 106, 137));
@@ -1373,7 +2031,7 @@ void Scene_Play::sRender()
 	//
 
 	// player score text
-	sf::Text pieText(m_game->assets().getFont("FutureMillennium"));
+	sf::Text pieText(m_game->assets().getFont(m_assetIds.futureMillennium));
 	pieText.setCharacterSize(60.0f);
 	pieText.setOutlineThickness(1.0f);
 	pieText.setOutlineColor(sf::Color(86, 106, 137));
@@ -1,11 +1,20 @@
 #pragma once
 
 #include "Scene.h"
+#include <array>
+#include <atomic>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
+#include "EnemyArchetypes.hpp"
 #include "EntityManager.hpp"
+#include "FlowField.hpp"
 #include "ParticleSystem.hpp"
+#include "Physics.hpp"
+#include "SpatialGrid.hpp"
+#include "TimerWheel.hpp"
+#include "Vec2Batch.hpp"
 
 class Scene_Play : public Scene
 {
@@ -15,11 +24,99 @@ class Scene_Play : public Scene
 		std::string WEAPON;
 	};
 
+	enum class TimedEventType
+	{
+		LifespanEnd,
+		KnockbackEnd,
+		InvulnerableEnd,
+		CooldownReady
+	};
+
+	enum class Weapon
+	{
+		Basic,
+		Special,
+		Bullet,
+		Ring,
+		Explode,
+		Whirl
+	};
+
+	struct TimedEvent
+	{
+		TimedEventType type = TimedEventType::LifespanEnd;
+		std::shared_ptr<Entity> entity;
+		int data = 0;
+	};
+
+	struct DamageEvent
+	{
+		std::shared_ptr<Entity> target;
+		Vec2f fromPos;
+		int damage = 0;
+		float knockback = 0;
+		int knockbackDuration = 0;
+	};
+
+	struct DamagePopup
+	{
+		std::shared_ptr<Entity> text;
+		int total = 0;
+		size_t frame = 0;
+	};
+
+	// everything this scene draws or plays, resolved from names once in init()
+	struct AssetIds
+	{
+		AnimationId stormheadIdle, stormheadRun, stormheadDeath;
+		AnimationId gem, heart, slash1, bullet1, ring1, explode1, ring2;
+		FontId futureMillennium;
+		SoundId plasticZap, coinZap, laserPebble, swordSlash, highWhoosh;
+		SoundId laserShot, fireSphere, fireHit, bubbleStep;
+	};
+
+	// an archetype from assets/enemies.txt, baked into a ready component set
+	struct EnemyType
+	{
+		EnemyArchetype archetype;
+		EntityBlueprint blueprint;
+		AnimationId idle, hit, death;
+		size_t lastSpawn = 0;
+	};
+
+	// push-out for one enemy from one overlapping neighbour
+	struct Contact
+	{
+		uint32_t enemy = 0;
+		Vec2f push;
+		bool stopX = false;
+		bool stopY = false;
+	};
+
+	// one per detection chunk, so workers never share a buffer
+	struct ContactBuffer
+	{
+		std::vector<Contact> contacts;
+		std::vector<uint64_t> hits;
+		std::vector<uint64_t> prevHitsX;
+		std::vector<uint64_t> prevHitsY;
+	};
+
+	// chunks of one resolveEnemyContacts call, claimed by whoever gets there first
+	struct ContactWork
+	{
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> done = 0;
+		size_t count = 0;
+	};
+
 protected:
 
 	std::string              m_levelPath;
 	std::string				 m_lastAction;
 	PlayerConfig             m_playerConfig;
+	AssetIds                 m_assetIds;
+	std::vector<EnemyType>	 m_enemyTypes;
 	const Vec2f              m_gridSize = { 64, 64 };
 	ParticleSystem			 m_particleSystem;
 	sf::View				 m_cameraView;
@@ -27,8 +124,58 @@ protected:
 	bool					 m_playerDied = false;
 	std::string				 m_musicName;
 	sf::Clock				 m_playClock;
+	TimerWheel<TimedEvent>	 m_timers;
+	FlowField				 m_flowField;
+	SpatialGrid				 m_enemyGrid;
+	SpatialGrid				 m_itemGrid = SpatialGrid(64.f);
+	std::vector<std::shared_ptr<Entity>> m_itemSlots;
+	std::vector<std::shared_ptr<Entity>> m_awakeItems;
+	std::vector<std::shared_ptr<Entity>> m_nextAwakeItems;
+	std::vector<size_t>		 m_queryResults;
+	float					 m_itemMaxHalfSize = 0;
+	size_t					 m_maxGems = 1500;  // "MaxGems n" in the level file
+	std::vector<DamageEvent> m_damageEvents;
+	std::unordered_map<size_t, DamagePopup> m_damagePopups;
+	std::vector<size_t>		 m_lastSoundFrame;
+	size_t					 m_maxPopupsPerFrame = 24;
+	std::vector<Vec2f>		 m_enemyPositions;
+	float					 m_enemyMaxHalfSize = 0;
+	std::vector<Entity*>	 m_moveEntities;
+	Vec2Array				 m_movePos;
+	Vec2Array				 m_moveVel;
+	std::vector<float>		 m_moveAccel;
+	std::vector<float>		 m_moveSteps;
+	float					 m_lodNear = 1.25f;   // view half-extents
+	float					 m_lodFar = 2.5f;
+	std::vector<Entity*>	 m_steerEntities;
+	Vec2Array				 m_steerVel;
+	Vec2Array				 m_steerDesired;
+	std::vector<float>		 m_steerScale;
+	std::vector<size_t>		 m_steerRefresh;   // indices into m_steerEntities re-aimed this tick
+	Vec2Array				 m_steerDir;
+	std::vector<float>		 m_steerSpeed;
+	size_t					 m_aiSlices = 4;
+	size_t					 m_aiMaxSlices = 8;
+	float					 m_aiBudgetMs = 1.0f;
+	float					 m_aiMs = 0;       // smoothed steering time, flow field excluded
+	AABBArray				 m_enemyBoxes;
+	AABBArray				 m_enemyPrevBoxes;
+	std::vector<size_t>		 m_enemySlots;
+	CollisionMatrix			 m_collisionMatrix;
+	std::array<EntityVec, static_cast<size_t>(CollisionLayer::Count)> m_colliders;
+	EntityVec				 m_enemyHitters;
+	std::vector<std::vector<uint64_t>> m_hitterMasks;
+	EntityVec				 m_sweptHitters;
+	std::vector<uint64_t>	 m_sweepMask;
+	std::vector<std::pair<float, size_t>> m_sweepHits;
+	std::vector<Vec2f>		 m_enemyHalfSizes;
+	std::vector<uint8_t>	 m_enemyPushable;
+	std::vector<uint8_t>	 m_enemyStepped;
+	std::vector<ContactBuffer> m_contactBuffers;
+	size_t					 m_contactChunk = 256;
 
 	void init(const std::string& levelPath);
+	void resolveAssets();
 	void loadLevel(const std::string& filename);
 
 	void onEnd();
@@ -38,31 +185,44 @@ protected:
 	void spawnPlayer();
 
 	void sSpawnEnemies();
-	void spawnChainBot();
-	void spawnBigChainBot();
-	void spawnBotWheel();
-	void spawnBigBotWheel();
+	bool loadEnemyTypes(const std::string& path);
+	void bakeEnemyTypes();
+	void spawnEnemyWave(const EnemyType& type, int level);
 	void enemyDied(std::shared_ptr<Entity> enemy);
 
 	void spawnGem(const Vec2f& pos);
 	void spawnHeart(const Vec2f& pos);
+	void addItem(std::shared_ptr<Entity> item);
+	void removeItem(std::shared_ptr<Entity> item);
+	void mergeGem(std::shared_ptr<Entity> into, std::shared_ptr<Entity> from);
 	void spawnTiles(const std::string& filename);
 	std::shared_ptr<Entity> player();
 	void sDoAction(const Action& action);
 	Vec2f gridToMidPixel(float gridX, float gridY, std::shared_ptr<Entity> entity);
-	std::shared_ptr<Entity> getNearestEnemy(std::shared_ptr<Entity> entity);
+	std::shared_ptr<Entity> getNearestEnemy(std::shared_ptr<Entity> entity, float maxDist);
 
 	void sScore();
 	void sDrag();
-	void sLifespan();
+	void sTimers();
 	void sAttraction();
-	void sKnockback();
 	void sMovement();
 	void sAI();
+	void adaptAiSlices(float aiMs);
+	void sSpatialIndex();
+	void sSimulationLod();
+	void gatherEnemyPositions();
 	void sStatus();
 	void sAnimation();
 	void sSound();
 	void sCollision();
+	void resolveEnemyContacts(const EntityVec& enemies, int enemyRings);
+	void collectItems(std::shared_ptr<Entity> collector);
+	bool applyEnemyHit(std::shared_ptr<Entity> enemy, std::shared_ptr<Entity> hitter);
+	bool sweepEnemyHits(std::shared_ptr<Entity> hitter, const EntityVec& enemies);
+	void detectEnemyContacts(const EntityVec& enemies, size_t begin, size_t end, int rings,
+		ContactBuffer& buffer);
+	void sCoalesceGems();
+	void sDamage();
 	void sDisappearingText();
 	void sCamera();
 	void sGui();
@@ -75,15 +235,24 @@ protected:
 	void spawnWhirlAttack(const Vec2f& targetPos);
 	void spawnBulletAttack(const Vec2f& targetPos);
 
+	void scheduleEvent(int delay, TimedEventType type, std::shared_ptr<Entity> entity, int data = 0);
+	void onTimedEvent(const TimedEvent& event);
+	void addLifespan(std::shared_ptr<Entity> entity, int lifespan);
+	void startCooldown(Weapon weapon, int cooldown);
+
+	void endKnockback(std::shared_ptr<Entity> target);
 	void applyKnockback(std::shared_ptr<Entity> target, const Vec2f& fromPos, float force, int duration);
 	bool applyAttraction(std::shared_ptr<Entity> attractor, std::shared_ptr<Entity> target);
-	void spawnDisappearingText(const std::string& text, const Vec2f& pos);
+	std::shared_ptr<Entity> spawnDisappearingText(const std::string& text, const Vec2f& pos);
+	void playSoundLimited(SoundId id, float volume, size_t minInterval, const Vec2f& pos);
 	bool applyDamage(std::shared_ptr<Entity> e1, std::shared_ptr<Entity> e2);
 	void renderShadow(std::shared_ptr<Entity> entity);
+	void drawColliderShape(const ColliderShape& shape, const Vec2f& pos);
 public:
 
 	Scene_Play() = default;
-	Scene_Play(GameEngine* gameEngine, const std::string& levelPath = "");
+	Scene_Play(GameEngine* gameEngine, const std::string& levelPath = "assets/play.txt");
 
 	void sRender();
+	void reloadAnimations(const std::vector<AnimationId>& ids);
 };
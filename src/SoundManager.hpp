@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Vec2.hpp"
+
+#include <SFML/Audio.hpp>
+#include <optional>
+#include <vector>
+
+struct SoundSettings
+{
+	size_t maxInstances = 4;
+	int priority = 0;
+};
+
+// Fixed pool of voices shared by every scene. A request either reuses a
+// stopped voice, restarts the oldest copy of the same sound once that sound
+// is at its instance limit, or steals the oldest voice of equal or lower
+// priority. Requests that are too quiet to hear, or that exceed the
+// per-frame start budget, are dropped before they touch a voice.
+class SoundManager
+{
+	struct Voice
+	{
+		std::optional<sf::Sound> sound;
+		const sf::SoundBuffer* buffer = nullptr;
+		int priority = 0;
+		size_t order = 0;
+	};
+
+	std::vector<Voice> m_voices;
+	Vec2f  m_listener;
+	float  m_minDistance = 300.f;
+	float  m_maxDistance = 1400.f;
+	float  m_cullVolume = 1.f;
+	size_t m_maxStartsPerFrame = 8;
+	size_t m_startsThisFrame = 0;
+	size_t m_order = 0;
+
+	static bool playing(const Voice& voice)
+	{
+		return voice.sound && voice.sound->getStatus() == sf::Sound::Status::Playing;
+	}
+
+public:
+	SoundManager(size_t voices = 32)
+		: m_voices(voices)
+	{
+	}
+
+	// call once per frame before scenes update
+	void update()
+	{
+		m_startsThisFrame = 0;
+	}
+
+	void setListener(const Vec2f& pos)
+	{
+		m_listener = pos;
+	}
+
+	// 1 inside minDistance of the listener, fading linearly to 0 at maxDistance
+	float attenuation(const Vec2f& pos) const
+	{
+		float distSq = m_listener.distToSquared(pos);
+		if (distSq <= m_minDistance * m_minDistance)
+			return 1.f;
+		if (distSq >= m_maxDistance * m_maxDistance)
+			return 0.f;
+		return 1.f - (std::sqrt(distSq) - m_minDistance) / (m_maxDistance - m_minDistance);
+	}
+
+	bool play(const sf::SoundBuffer& buffer, const SoundSettings& settings, float volume, float pitch)
+	{
+		if (volume < m_cullVolume || m_startsThisFrame >= m_maxStartsPerFrame)
+			return false;
+
+		Voice* freeVoice = nullptr;
+		Voice* oldestSame = nullptr;
+		Voice* victim = nullptr;
+		size_t sameCount = 0;
+		for (auto& voice : m_voices)
+		{
+			if (!playing(voice))
+			{
+				if (!freeVoice)
+					freeVoice = &voice;
+				continue;
+			}
+
+			if (voice.buffer == &buffer)
+			{
+				sameCount++;
+				if (!oldestSame || voice.order < oldestSame->order)
+					oldestSame = &voice;
+			}
+			if (voice.priority <= settings.priority && (!victim || voice.priority < victim->priority ||
+				(voice.priority == victim->priority && voice.order < victim->order)))
+			{
+				victim = &voice;
+			}
+		}
+
+		Voice* target = victim;
+		if (sameCount >= settings.maxInstances)
+			target = oldestSame;
+		else if (freeVoice)
+			target = freeVoice;
+		if (!target)
+			return false;
+
+		if (!target->sound)
+		{
+			target->sound.emplace(buffer);
+		}
+		else
+		{
+			target->sound->stop();
+			target->sound->setBuffer(buffer);
+		}
+		target->buffer = &buffer;
+		target->priority = settings.priority;
+		target->order = m_order++;
+		target->sound->setVolume(volume);
+		target->sound->setPitch(pitch);
+		target->sound->play();
+		m_startsThisFrame++;
+		return true;
+	}
+
+	bool play(const sf::SoundBuffer& buffer, const SoundSettings& settings, float volume, float pitch,
+		const Vec2f& pos)
+	{
+		return play(buffer, settings, volume * attenuation(pos), pitch);
+	}
+
+	void stopAll()
+	{
+		for (auto& voice : m_voices)
+		{
+			if (voice.sound)
+				voice.sound->stop();
+		}
+	}
+
+	size_t activeVoices() const
+	{
+		size_t count = 0;
+		for (auto& voice : m_voices)
+		{
+			count += playing(voice);
+		}
+		return count;
+	}
+};
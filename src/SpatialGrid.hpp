@@ -0,0 +1,259 @@
+#pragma once
+
+#include "Vec2.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Unbounded uniform hash grid over points, addressed by integer handles.
+// Either rebuild it once per tick from a position list (handles are then the
+// list indices), or keep it alive and insert/move/remove items as they
+// change. Nearest, k-nearest and radius queries walk rings of cells outwards
+// from the query point and only compare squared distances.
+class SpatialGrid
+{
+	struct AcceptAll
+	{
+		bool operator()(size_t) const { return true; }
+	};
+
+	float m_cellSize = 0;
+	std::vector<Vec2f> m_positions;
+	std::vector<uint64_t> m_itemKeys;
+	std::vector<uint32_t> m_free;
+	std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+
+	int cellCoord(float v) const
+	{
+		return static_cast<int>(std::floor(v / m_cellSize));
+	}
+
+	static uint64_t key(int cx, int cy)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+	}
+
+	uint64_t keyOf(const Vec2f& pos) const
+	{
+		return key(cellCoord(pos.x), cellCoord(pos.y));
+	}
+
+	void unlink(size_t handle)
+	{
+		auto& items = m_cells[m_itemKeys[handle]];
+		auto it = std::find(items.begin(), items.end(), static_cast<uint32_t>(handle));
+		*it = items.back();
+		items.pop_back();
+	}
+
+	const std::vector<uint32_t>* cell(int cx, int cy) const
+	{
+		auto it = m_cells.find(key(cx, cy));
+		if (it == m_cells.end() || it->second.empty())
+			return nullptr;
+		return &it->second;
+	}
+
+	// visit every cell on the square ring at Chebyshev distance r
+	template <typename F>
+	void forEachInRing(int cx, int cy, int r, F&& fn) const
+	{
+		for (int x = cx - r; x <= cx + r; x++)
+		{
+			for (int y = cy - r; y <= cy + r; y += (x == cx - r || x == cx + r || r == 0) ? 1 : 2 * r)
+			{
+				if (auto* items = cell(x, y))
+				{
+					for (uint32_t i : *items)
+						fn(static_cast<size_t>(i));
+				}
+			}
+		}
+	}
+
+	// points outside rings 0..r are at least this far from pos
+	float clearance(const Vec2f& pos, int cx, int cy, int r) const
+	{
+		float left = pos.x - (cx - r) * m_cellSize;
+		float right = (cx + r + 1) * m_cellSize - pos.x;
+		float top = pos.y - (cy - r) * m_cellSize;
+		float bottom = (cy + r + 1) * m_cellSize - pos.y;
+		return std::min({ left, right, top, bottom });
+	}
+
+public:
+	SpatialGrid(float cellSize = 128.f)
+		: m_cellSize(cellSize)
+	{
+	}
+
+	void clear(size_t expected = 0)
+	{
+		// keep bucket capacity between ticks, but drop buckets that have gone stale
+		if (m_cells.size() > 4 * expected + 64)
+			m_cells.clear();
+		for (auto& [k, items] : m_cells)
+			items.clear();
+
+		m_positions.clear();
+		m_itemKeys.clear();
+		m_free.clear();
+	}
+
+	void build(const std::vector<Vec2f>& positions)
+	{
+		clear(positions.size());
+		for (auto& pos : positions)
+		{
+			insert(pos);
+		}
+	}
+
+	size_t insert(const Vec2f& pos)
+	{
+		size_t handle = m_positions.size();
+		if (!m_free.empty())
+		{
+			handle = m_free.back();
+			m_free.pop_back();
+		}
+		else
+		{
+			m_positions.emplace_back();
+			m_itemKeys.emplace_back();
+		}
+
+		m_positions[handle] = pos;
+		m_itemKeys[handle] = keyOf(pos);
+		m_cells[m_itemKeys[handle]].push_back(static_cast<uint32_t>(handle));
+		return handle;
+	}
+
+	void remove(size_t handle)
+	{
+		unlink(handle);
+		m_free.push_back(static_cast<uint32_t>(handle));
+	}
+
+	void move(size_t handle, const Vec2f& pos)
+	{
+		m_positions[handle] = pos;
+		uint64_t newKey = keyOf(pos);
+		if (newKey == m_itemKeys[handle])
+			return;
+
+		unlink(handle);
+		m_itemKeys[handle] = newKey;
+		m_cells[newKey].push_back(static_cast<uint32_t>(handle));
+	}
+
+	size_t size() const
+	{
+		return m_positions.size() - m_free.size();
+	}
+
+	const Vec2f& position(size_t handle) const
+	{
+		return m_positions[handle];
+	}
+
+	// index of the closest accepted item within maxDist, or -1
+	template <typename Accept = AcceptAll>
+	int nearest(const Vec2f& pos, float maxDist, Accept&& accept = Accept()) const
+	{
+		int cx = cellCoord(pos.x);
+		int cy = cellCoord(pos.y);
+		int maxRing = static_cast<int>(std::ceil(maxDist / m_cellSize));
+		float bestDistSq = maxDist * maxDist;
+		int best = -1;
+
+		for (int r = 0; r <= maxRing; r++)
+		{
+			forEachInRing(cx, cy, r, [&](size_t i)
+			{
+				float distSq = m_positions[i].distToSquared(pos);
+				if (distSq < bestDistSq && accept(i))
+				{
+					bestDistSq = distSq;
+					best = static_cast<int>(i);
+				}
+			});
+
+			float clear = clearance(pos, cx, cy, r);
+			if (best >= 0 && bestDistSq <= clear * clear)
+				break;
+		}
+		return best;
+	}
+
+	// up to k accepted items within maxDist, closest first
+	template <typename Accept = AcceptAll>
+	void kNearest(const Vec2f& pos, size_t k, float maxDist, std::vector<size_t>& out,
+		Accept&& accept = Accept()) const
+	{
+		out.clear();
+		if (k == 0)
+			return;
+
+		int cx = cellCoord(pos.x);
+		int cy = cellCoord(pos.y);
+		int maxRing = static_cast<int>(std::ceil(maxDist / m_cellSize));
+		float maxDistSq = maxDist * maxDist;
+
+		// max-heap on distance so the worst candidate is always at the front
+		std::vector<std::pair<float, size_t>> heap;
+		for (int r = 0; r <= maxRing; r++)
+		{
+			forEachInRing(cx, cy, r, [&](size_t i)
+			{
+				float distSq = m_positions[i].distToSquared(pos);
+				if (distSq >= maxDistSq || (heap.size() == k && distSq >= heap.front().first) || !accept(i))
+					return;
+				if (heap.size() == k)
+				{
+					std::pop_heap(heap.begin(), heap.end());
+					heap.pop_back();
+				}
+				heap.emplace_back(distSq, i);
+				std::push_heap(heap.begin(), heap.end());
+			});
+
+			float clear = clearance(pos, cx, cy, r);
+			if (heap.size() == k && heap.front().first <= clear * clear)
+				break;
+		}
+
+		std::sort_heap(heap.begin(), heap.end());
+		for (auto& [distSq, i] : heap)
+			out.push_back(i);
+	}
+
+	// every accepted item strictly within radius, in no particular order
+	template <typename Accept = AcceptAll>
+	void withinRadius(const Vec2f& pos, float radius, std::vector<size_t>& out,
+		Accept&& accept = Accept()) const
+	{
+		out.clear();
+		float radiusSq = radius * radius;
+		int x0 = cellCoord(pos.x - radius), x1 = cellCoord(pos.x + radius);
+		int y0 = cellCoord(pos.y - radius), y1 = cellCoord(pos.y + radius);
+		for (int x = x0; x <= x1; x++)
+		{
+			for (int y = y0; y <= y1; y++)
+			{
+				auto* items = cell(x, y);
+				if (!items)
+					continue;
+				for (uint32_t i : *items)
+				{
+					if (m_positions[i].distToSquared(pos) < radiusSq && accept(i))
+						out.push_back(i);
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads pulling jobs from one FIFO queue.
+class ThreadPool
+{
+	std::vector<std::thread> m_workers;
+	std::queue<std::function<void()>> m_jobs;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_stopping = false;
+
+	void work()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+				if (m_stopping && m_jobs.empty())
+					return;
+				job = std::move(m_jobs.front());
+				m_jobs.pop();
+			}
+			job();
+		}
+	}
+
+public:
+	// one thread is left for the main loop
+	ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()) - 1)
+	{
+		threads = std::max<size_t>(threads, 1);
+		for (size_t i = 0; i < threads; i++)
+		{
+			m_workers.emplace_back([this] { work(); });
+		}
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template <typename F>
+	auto submit(F&& fn) -> std::future<std::invoke_result_t<F>>
+	{
+		using Result = std::invoke_result_t<F>;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+		auto future = task->get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.emplace([task] { (*task)(); });
+		}
+		m_wake.notify_one();
+		return future;
+	}
+
+	size_t size() const
+	{
+		return m_workers.size();
+	}
+};
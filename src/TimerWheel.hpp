@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Hierarchical timer wheel indexed by frame number. Scheduling is O(1) and
+// advancing only touches the timers that fire (plus an occasional cascade of
+// one slot into the level below), so the cost per frame does not depend on
+// how many timers are pending.
+//
+// Level L has 64 slots of 64^L frames each; timers further out than the top
+// level sit in an overflow list that is redistributed when the wheel wraps.
+// Timers cannot be cancelled: handlers should check that the event is still
+// relevant when it fires.
+template <typename T>
+class TimerWheel
+{
+	static constexpr size_t   Bits = 6;
+	static constexpr size_t   Slots = size_t(1) << Bits;
+	static constexpr size_t   Levels = 4;
+	static constexpr uint64_t Span = uint64_t(1) << (Bits * Levels);
+
+	struct Timer
+	{
+		uint64_t due = 0;
+		T payload;
+	};
+
+	std::array<std::array<std::vector<Timer>, Slots>, Levels> m_wheels;
+	std::vector<Timer> m_overflow;
+	std::vector<Timer> m_firing;
+	uint64_t m_now = 0;
+	size_t m_count = 0;
+
+	void place(Timer&& timer)
+	{
+		uint64_t delta = timer.due - m_now;
+		for (size_t level = 0; level < Levels; level++)
+		{
+			if (delta < (uint64_t(1) << (Bits * (level + 1))))
+			{
+				size_t slot = (timer.due >> (Bits * level)) & (Slots - 1);
+				m_wheels[level][slot].push_back(std::move(timer));
+				return;
+			}
+		}
+		m_overflow.push_back(std::move(timer));
+	}
+
+	void cascade(std::vector<Timer>& timers)
+	{
+		m_firing.clear();
+		m_firing.swap(timers);
+		for (auto& timer : m_firing)
+		{
+			place(std::move(timer));
+		}
+		m_firing.clear();
+	}
+
+	template <typename F>
+	void tick(F&& fire)
+	{
+		m_now++;
+
+		if (m_now % Span == 0)
+		{
+			cascade(m_overflow);
+		}
+		for (size_t level = Levels - 1; level > 0; level--)
+		{
+			uint64_t mask = (uint64_t(1) << (Bits * level)) - 1;
+			if ((m_now & mask) == 0)
+			{
+				size_t slot = (m_now >> (Bits * level)) & (Slots - 1);
+				cascade(m_wheels[level][slot]);
+			}
+		}
+
+		// swap out first so handlers can schedule new timers while firing
+		auto& slot = m_wheels[0][m_now & (Slots - 1)];
+		if (slot.empty())
+			return;
+
+		std::vector<Timer> firing;
+		firing.swap(slot);
+		m_count -= firing.size();
+		for (auto& timer : firing)
+		{
+			fire(timer.payload);
+		}
+		firing.clear();
+		if (slot.empty())
+			slot.swap(firing); // keep the capacity around for the next lap
+	}
+
+public:
+	TimerWheel() = default;
+
+	void clear(uint64_t now = 0)
+	{
+		for (auto& wheel : m_wheels)
+		{
+			for (auto& slot : wheel)
+				slot.clear();
+		}
+		m_overflow.clear();
+		m_now = now;
+		m_count = 0;
+	}
+
+	// fire payload on the given frame; frames already reached fire on the next one
+	void schedule(uint64_t dueFrame, T payload)
+	{
+		Timer timer;
+		timer.due = dueFrame > m_now ? dueFrame : m_now + 1;
+		timer.payload = std::move(payload);
+		place(std::move(timer));
+		m_count++;
+	}
+
+	// fire every timer due up to and including frame, in frame order
+	template <typename F>
+	void advance(uint64_t frame, F&& fire)
+	{
+		while (m_now < frame)
+		{
+			tick(fire);
+		}
+	}
+
+	uint64_t now() const
+	{
+		return m_now;
+	}
+
+	size_t size() const
+	{
+		return m_count;
+	}
+};
@@ -1,6 +1,8 @@
 #pragma once
 
+#ifndef VEC2_NO_SFML
 #include <SFML/Graphics.hpp>
+#endif
 #include <cmath>
 
 template <typename T>
@@ -16,6 +18,7 @@ public:
 		: x(xin), y(yin)
 	{ }
 
+#ifndef VEC2_NO_SFML
 	Vec2(const sf::Vector2<T>& vec)
 		: x(vec.x), y(vec.y)
 	{ }
@@ -38,6 +41,7 @@ public:
 	{
 		return sf::Vector2<U>(static_cast<U>(x), static_cast<U>(y));
 	}
+#endif
 
 	Vec2 operator + (const Vec2& rhs) const
 	{
@@ -116,6 +120,17 @@ public:
 	{
 		return static_cast<float>(x * x + y * y);
 	}
+
+	float dot(const Vec2& rhs) const
+	{
+		return static_cast<float>(x * rhs.x + y * rhs.y);
+	}
+
+	// rotated a quarter turn counter-clockwise
+	Vec2 perp() const
+	{
+		return Vec2(-y, x);
+	}
 	
 	Vec2 normalize() const
 	{
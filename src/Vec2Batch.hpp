@@ -0,0 +1,336 @@
+#pragma once
+
+#include "Vec2.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// define VEC2_BATCH_NO_SIMD to force the scalar path
+#ifndef VEC2_BATCH_NO_SIMD
+#if defined(__AVX2__)
+#define VEC2_BATCH_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VEC2_BATCH_SSE 1
+#include <emmintrin.h>
+#endif
+#endif
+
+// Structure-of-arrays batch math for the per-entity Vec2 loops. Kernels run
+// 8 lanes at a time with AVX2, 4 with SSE, and fall back to scalar for the
+// tail and on other targets.
+//
+// Every path computes 1 / sqrt with IEEE square root and division, which are
+// correctly rounded, so a vector gives the same bits on any CPU, with SSE or
+// AVX2, and wherever it sits in the array. Replays depend on that. Results
+// stay within Vec2BatchTolerance (relative) of the scalar Vec2 versions;
+// tests/Vec2BatchTest.cpp checks it.
+
+// lengths below this are treated as zero, like Vec2::normalize does for 0
+constexpr float Vec2BatchEpsilon = 1e-30f;
+constexpr float Vec2BatchTolerance = 5e-7f;
+
+struct Float1
+{
+	static constexpr size_t Width = 1;
+	float v;
+
+	static Float1 load(const float* p) { return { *p }; }
+	void store(float* p) const { *p = v; }
+	static Float1 set(float s) { return { s }; }
+
+	friend Float1 operator+(Float1 a, Float1 b) { return { a.v + b.v }; }
+	friend Float1 operator-(Float1 a, Float1 b) { return { a.v - b.v }; }
+	friend Float1 operator*(Float1 a, Float1 b) { return { a.v * b.v }; }
+	friend Float1 min(Float1 a, Float1 b) { return { std::min(a.v, b.v) }; }
+
+	// 1 / sqrt(a), or 0 where a is zero
+	friend Float1 rsqrtOrZero(Float1 a)
+	{
+		return { a.v > Vec2BatchEpsilon ? 1.f / std::sqrt(a.v) : 0.f };
+	}
+
+	friend Float1 ifZero(Float1 a, Float1 then, Float1 otherwise)
+	{
+		return a.v == 0.f ? then : otherwise;
+	}
+
+	// one bit per lane where a < b
+	friend unsigned lessMask(Float1 a, Float1 b)
+	{
+		return a.v < b.v ? 1u : 0u;
+	}
+};
+
+#ifdef VEC2_BATCH_SSE
+struct Float4
+{
+	static constexpr size_t Width = 4;
+	__m128 v;
+
+	static Float4 load(const float* p) { return { _mm_loadu_ps(p) }; }
+	void store(float* p) const { _mm_storeu_ps(p, v); }
+	static Float4 set(float s) { return { _mm_set1_ps(s) }; }
+
+	friend Float4 operator+(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+	friend Float4 operator-(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+	friend Float4 operator*(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+	friend Float4 min(Float4 a, Float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+
+	friend Float4 rsqrtOrZero(Float4 a)
+	{
+		__m128 r = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(a.v));
+		return { _mm_and_ps(r, _mm_cmpgt_ps(a.v, _mm_set1_ps(Vec2BatchEpsilon))) };
+	}
+
+	friend Float4 ifZero(Float4 a, Float4 then, Float4 otherwise)
+	{
+		__m128 mask = _mm_cmpeq_ps(a.v, _mm_setzero_ps());
+		return { _mm_or_ps(_mm_and_ps(mask, then.v), _mm_andnot_ps(mask, otherwise.v)) };
+	}
+
+	friend unsigned lessMask(Float4 a, Float4 b)
+	{
+		return static_cast<unsigned>(_mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)));
+	}
+};
+#endif
+
+#ifdef VEC2_BATCH_AVX2
+struct Float8
+{
+	static constexpr size_t Width = 8;
+	__m256 v;
+
+	static Float8 load(const float* p) { return { _mm256_loadu_ps(p) }; }
+	void store(float* p) const { _mm256_storeu_ps(p, v); }
+	static Float8 set(float s) { return { _mm256_set1_ps(s) }; }
+
+	friend Float8 operator+(Float8 a, Float8 b) { return { _mm256_add_ps(a.v, b.v) }; }
+	friend Float8 operator-(Float8 a, Float8 b) { return { _mm256_sub_ps(a.v, b.v) }; }
+	friend Float8 operator*(Float8 a, Float8 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+	friend Float8 min(Float8 a, Float8 b) { return { _mm256_min_ps(a.v, b.v) }; }
+
+	friend Float8 rsqrtOrZero(Float8 a)
+	{
+		__m256 r = _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_sqrt_ps(a.v));
+		return { _mm256_and_ps(r, _mm256_cmp_ps(a.v, _mm256_set1_ps(Vec2BatchEpsilon), _CMP_GT_OQ)) };
+	}
+
+	friend Float8 ifZero(Float8 a, Float8 then, Float8 otherwise)
+	{
+		__m256 mask = _mm256_cmp_ps(a.v, _mm256_setzero_ps(), _CMP_EQ_OQ);
+		return { _mm256_blendv_ps(otherwise.v, then.v, mask) };
+	}
+
+	friend unsigned lessMask(Float8 a, Float8 b)
+	{
+		return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)));
+	}
+};
+using FloatN = Float8;
+#elif defined(VEC2_BATCH_SSE)
+using FloatN = Float4;
+#else
+using FloatN = Float1;
+#endif
+
+// separate x and y arrays, so a batch of lanes is one load per component
+struct Vec2Array
+{
+	std::vector<float> x;
+	std::vector<float> y;
+
+	size_t size() const
+	{
+		return x.size();
+	}
+
+	void clear()
+	{
+		x.clear();
+		y.clear();
+	}
+
+	void push_back(const Vec2f& v)
+	{
+		x.push_back(v.x);
+		y.push_back(v.y);
+	}
+
+	Vec2f operator[](size_t i) const
+	{
+		return Vec2f(x[i], y[i]);
+	}
+};
+
+// N vectors in registers, mirroring the Vec2 operations
+template <typename F>
+struct Vec2xN
+{
+	F x;
+	F y;
+
+	static Vec2xN load(const Vec2Array& a, size_t i)
+	{
+		return { F::load(&a.x[i]), F::load(&a.y[i]) };
+	}
+
+	void store(Vec2Array& a, size_t i) const
+	{
+		x.store(&a.x[i]);
+		y.store(&a.y[i]);
+	}
+
+	Vec2xN operator+(const Vec2xN& rhs) const { return { x + rhs.x, y + rhs.y }; }
+	Vec2xN operator-(const Vec2xN& rhs) const { return { x - rhs.x, y - rhs.y }; }
+	Vec2xN operator*(F s) const { return { x * s, y * s }; }
+
+	F lengthSquared() const
+	{
+		return x * x + y * y;
+	}
+
+	F length() const
+	{
+		F len2 = lengthSquared();
+		return len2 * rsqrtOrZero(len2);
+	}
+
+	// zero vectors stay zero
+	Vec2xN normalize() const
+	{
+		return *this * rsqrtOrZero(lengthSquared());
+	}
+
+	Vec2xN clampLength(F maxLength) const
+	{
+		return *this * min(maxLength * rsqrtOrZero(lengthSquared()), F::set(1.f));
+	}
+};
+
+using Vec2x1 = Vec2xN<Float1>;
+#ifdef VEC2_BATCH_SSE
+using Vec2x4 = Vec2xN<Float4>;
+#endif
+#ifdef VEC2_BATCH_AVX2
+using Vec2x8 = Vec2xN<Float8>;
+#endif
+
+namespace Vec2Batch
+{
+	// fn(lanes, i) with lanes a FloatN or, for the tail, a Float1
+	template <typename Fn>
+	void forEach(size_t begin, size_t end, Fn&& fn)
+	{
+		size_t i = begin;
+		for (; i + FloatN::Width <= end; i += FloatN::Width)
+			fn(FloatN{}, i);
+		for (; i < end; i++)
+			fn(Float1{}, i);
+	}
+
+	template <typename Fn>
+	void forEach(size_t count, Fn&& fn)
+	{
+		forEach(0, count, fn);
+	}
+
+	inline void add(Vec2Array& a, const Vec2Array& b)
+	{
+		forEach(a.size(), [&](auto lanes, size_t i)
+		{
+			using V = Vec2xN<decltype(lanes)>;
+			(V::load(a, i) + V::load(b, i)).store(a, i);
+		});
+	}
+
+	inline void scale(Vec2Array& a, const std::vector<float>& s)
+	{
+		forEach(a.size(), [&](auto lanes, size_t i)
+		{
+			using F = decltype(lanes);
+			(Vec2xN<F>::load(a, i) * F::load(&s[i])).store(a, i);
+		});
+	}
+
+	inline void length(const Vec2Array& a, std::vector<float>& out)
+	{
+		out.resize(a.size());
+		forEach(a.size(), [&](auto lanes, size_t i)
+		{
+			Vec2xN<decltype(lanes)>::load(a, i).length().store(&out[i]);
+		});
+	}
+
+	inline void normalize(Vec2Array& a)
+	{
+		forEach(a.size(), [&](auto lanes, size_t i)
+		{
+			using V = Vec2xN<decltype(lanes)>;
+			V::load(a, i).normalize().store(a, i);
+		});
+	}
+
+	inline void clampLength(Vec2Array& a, float maxLength)
+	{
+		forEach(a.size(), [&](auto lanes, size_t i)
+		{
+			using F = decltype(lanes);
+			Vec2xN<F>::load(a, i).clampLength(F::set(maxLength)).store(a, i);
+		});
+	}
+
+	// vel = vel.normalize() * (vel.length() + accel); pos += vel. Lanes with
+	// no acceleration keep their velocity bit for bit.
+	inline void integrate(Vec2Array& pos, Vec2Array& vel, const std::vector<float>& accel)
+	{
+		forEach(pos.size(), [&](auto lanes, size_t i)
+		{
+			using F = decltype(lanes);
+			using V = Vec2xN<F>;
+			V v = V::load(vel, i);
+			F a = F::load(&accel[i]);
+			F inv = rsqrtOrZero(v.lengthSquared());
+			F factor = (v.lengthSquared() * inv + a) * inv;
+			v = v * ifZero(a, F::set(1.f), factor);
+			v.store(vel, i);
+			(V::load(pos, i) + v).store(pos, i);
+		});
+	}
+
+	// integrate() over steps[i] ticks at once: the acceleration is applied
+	// steps times up front and the new velocity held for the whole span.
+	inline void integrate(Vec2Array& pos, Vec2Array& vel, const std::vector<float>& accel,
+		const std::vector<float>& steps)
+	{
+		forEach(pos.size(), [&](auto lanes, size_t i)
+		{
+			using F = decltype(lanes);
+			using V = Vec2xN<F>;
+			V v = V::load(vel, i);
+			F a = F::load(&accel[i]);
+			F k = F::load(&steps[i]);
+			F inv = rsqrtOrZero(v.lengthSquared());
+			F factor = (v.lengthSquared() * inv + a * k) * inv;
+			v = v * ifZero(a, F::set(1.f), factor);
+			v.store(vel, i);
+			(V::load(pos, i) + v * k).store(pos, i);
+		});
+	}
+
+	// vel += (target - vel) * rate
+	inline void approach(Vec2Array& vel, const Vec2Array& target, const std::vector<float>& rate)
+	{
+		forEach(vel.size(), [&](auto lanes, size_t i)
+		{
+			using F = decltype(lanes);
+			using V = Vec2xN<F>;
+			V v = V::load(vel, i);
+			(v + (V::load(target, i) - v) * F::load(&rate[i])).store(vel, i);
+		});
+	}
+}
@@ -2,9 +2,44 @@
 #include <SFML/Audio.hpp>
 
 #include "GameEngine.h"
+#include "AssetPack.hpp"
 
-int main()
+#include <string>
+
+// usage: SurvivorLike [--record <file>] [--replay <file> [--headless]]
+//        SurvivorLike --build-pack
+int main(int argc, char* argv[])
 {
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--build-pack")
+            return AssetPack::build("assets/assets.txt", "assets/assets.pack") ? 0 : 1;
+    }
+
     GameEngine g("assets/assets.txt");
+
+    bool headless = false;
+    std::string recordPath, replayPath;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (arg == "--headless")
+            headless = true;
+    }
+
+    if (!replayPath.empty())
+    {
+        if (!g.playReplay(replayPath, headless))
+            return 1;
+    }
+    else if (!recordPath.empty())
+    {
+        g.recordReplay(recordPath);
+    }
+
     g.run();
 }
\ No newline at end of file
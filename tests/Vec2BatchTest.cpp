@@ -0,0 +1,191 @@
+// Checks the Vec2Batch kernels against the scalar Vec2 versions on whichever
+// path the build picks, over array sizes that leave every possible tail.
+
+#include "Vec2Batch.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+static int s_failures = 0;
+static float s_worstError = 0;
+
+// |got - want| within Vec2BatchTolerance of scale
+static void check(const char* kernel, size_t size, size_t i, float got, float want, float scale)
+{
+	float error = std::abs(got - want) / std::max(scale, 1e-30f);
+	s_worstError = std::max(s_worstError, error);
+	if (error <= Vec2BatchTolerance)
+		return;
+	if (s_failures++ < 20)
+		std::printf("%s: size %zu, index %zu: got %.9g, want %.9g (relative error %g)\n",
+			kernel, size, i, got, want, error);
+}
+
+static void checkExact(const char* kernel, size_t size, size_t i, float got, float want)
+{
+	if (std::memcmp(&got, &want, sizeof(float)) == 0)
+		return;
+	if (s_failures++ < 20)
+		std::printf("%s: size %zu, index %zu: got %.9g, want exactly %.9g\n", kernel, size, i, got, want);
+}
+
+// lengths from 1e-6 to 1e6 with random direction and sign, plus a zero vector
+static Vec2Array randomVectors(std::mt19937& rng, size_t count)
+{
+	std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+	std::uniform_real_distribution<float> exponent(-6.f, 6.f);
+	Vec2Array a;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i % 7 == 3)
+		{
+			a.push_back(Vec2f(0, 0));
+			continue;
+		}
+		float len = std::pow(10.f, exponent(rng));
+		float t = angle(rng);
+		a.push_back(Vec2f(std::cos(t) * len, std::sin(t) * len));
+	}
+	return a;
+}
+
+static std::vector<float> randomFloats(std::mt19937& rng, size_t count, float lo, float hi)
+{
+	std::uniform_real_distribution<float> dist(lo, hi);
+	std::vector<float> v(count);
+	for (size_t i = 0; i < count; i++)
+		v[i] = i % 5 == 1 ? 0.f : dist(rng);
+	return v;
+}
+
+static void testLength(std::mt19937& rng, size_t size)
+{
+	Vec2Array a = randomVectors(rng, size);
+	std::vector<float> out;
+	Vec2Batch::length(a, out);
+	for (size_t i = 0; i < size; i++)
+		check("length", size, i, out[i], a[i].length(), a[i].length());
+}
+
+static void testNormalize(std::mt19937& rng, size_t size)
+{
+	Vec2Array a = randomVectors(rng, size);
+	Vec2Array out = a;
+	Vec2Batch::normalize(out);
+	for (size_t i = 0; i < size; i++)
+	{
+		Vec2f want = a[i].normalize();
+		check("normalize", size, i, out.x[i], want.x, 1.f);
+		check("normalize", size, i, out.y[i], want.y, 1.f);
+	}
+}
+
+static void testClampLength(std::mt19937& rng, size_t size)
+{
+	const float maxLength = 3.5f;
+	Vec2Array a = randomVectors(rng, size);
+	Vec2Array out = a;
+	Vec2Batch::clampLength(out, maxLength);
+	for (size_t i = 0; i < size; i++)
+	{
+		Vec2f want = a[i].length() > maxLength ? a[i].normalize() * maxLength : a[i];
+		float scale = std::min(a[i].length(), maxLength);
+		check("clampLength", size, i, out.x[i], want.x, scale);
+		check("clampLength", size, i, out.y[i], want.y, scale);
+	}
+}
+
+// steps empty for the single-tick overload
+static void testIntegrate(std::mt19937& rng, size_t size, bool withSteps)
+{
+	const char* kernel = withSteps ? "integrate(steps)" : "integrate";
+	Vec2Array pos = randomVectors(rng, size);
+	Vec2Array vel = randomVectors(rng, size);
+	std::vector<float> accel = randomFloats(rng, size, -0.5f, 0.5f);
+	std::vector<float> steps(size, 1.f);
+	if (withSteps)
+	{
+		std::uniform_int_distribution<int> dist(1, 3);
+		for (auto& k : steps)
+			k = static_cast<float>(dist(rng));
+	}
+
+	Vec2Array newPos = pos;
+	Vec2Array newVel = vel;
+	if (withSteps)
+		Vec2Batch::integrate(newPos, newVel, accel, steps);
+	else
+		Vec2Batch::integrate(newPos, newVel, accel);
+
+	for (size_t i = 0; i < size; i++)
+	{
+		float k = steps[i];
+		Vec2f v = vel[i];
+		if (accel[i] == 0)
+		{
+			checkExact(kernel, size, i, newVel.x[i], v.x);
+			checkExact(kernel, size, i, newVel.y[i], v.y);
+		}
+		else
+		{
+			v = v.normalize() * (v.length() + accel[i] * k);
+		}
+		Vec2f p = pos[i] + v * k;
+
+		float velScale = vel[i].length() + std::abs(accel[i] * k);
+		check(kernel, size, i, newVel.x[i], v.x, velScale);
+		check(kernel, size, i, newVel.y[i], v.y, velScale);
+		check(kernel, size, i, newPos.x[i], p.x, pos[i].length() + velScale * k);
+		check(kernel, size, i, newPos.y[i], p.y, pos[i].length() + velScale * k);
+	}
+}
+
+// A vector gives the same bits in a full group of lanes and in the tail.
+static void testTailMatchesLanes(std::mt19937& rng)
+{
+	const size_t size = FloatN::Width + 1;
+	Vec2Array source = randomVectors(rng, 64);
+	for (size_t s = 0; s < source.size(); s++)
+	{
+		Vec2Array a;
+		for (size_t i = 0; i < size; i++)
+			a.push_back(source[s]);
+
+		std::vector<float> len;
+		Vec2Batch::length(a, len);
+		Vec2Batch::normalize(a);
+		checkExact("tail length", size, size - 1, len[size - 1], len[0]);
+		checkExact("tail normalize", size, size - 1, a.x[size - 1], a.x[0]);
+		checkExact("tail normalize", size, size - 1, a.y[size - 1], a.y[0]);
+	}
+}
+
+int main()
+{
+#ifdef EXPECTED_WIDTH
+	if (FloatN::Width != EXPECTED_WIDTH)
+	{
+		std::printf("built for %d lanes but FloatN is %zu wide\n", EXPECTED_WIDTH, FloatN::Width);
+		return 1;
+	}
+#endif
+
+	std::mt19937 rng(1234);
+	for (int round = 0; round < 50; round++)
+	{
+		for (size_t size = 0; size <= 3 * 8 + 7; size++)
+		{
+			testLength(rng, size);
+			testNormalize(rng, size);
+			testClampLength(rng, size);
+			testIntegrate(rng, size, false);
+			testIntegrate(rng, size, true);
+		}
+	}
+	testTailMatchesLanes(rng);
+
+	std::printf("%zu lanes: %d failures, worst relative error %g\n", FloatN::Width, s_failures, s_worstError);
+	return s_failures == 0 ? 0 : 1;
+}